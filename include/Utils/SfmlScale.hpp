@@ -0,0 +1,16 @@
+#ifndef SFMLSCALE_HPP
+#define SFMLSCALE_HPP
+
+#include <SFML/System/Vector2.hpp>
+#include "Utils/Scale.hpp"
+
+// Перегрузки px2m/m2px для sf::Vector2f — только для кода с окном (main, ввод, 2D-рендер).
+// Ядро симуляции работает с Vec2f и про SFML не знает.
+
+inline sf::Vector2f px2m(const sf::Vector2f& v) { return { v.x/PPM, v.y/PPM }; }
+inline sf::Vector2f m2px(const sf::Vector2f& v) { return { v.x*PPM, v.y*PPM }; }
+
+inline Vec2f        toVec2(const sf::Vector2f& v) { return { v.x, v.y }; }
+inline sf::Vector2f toSf(const Vec2f& v)          { return { v.x, v.y }; }
+
+#endif //SFMLSCALE_HPP
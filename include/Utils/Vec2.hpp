@@ -0,0 +1,15 @@
+#ifndef VEC2_HPP
+#define VEC2_HPP
+
+/// Минимальный 2D-вектор без зависимости от SFML — используется ядром симуляции
+/// (physics::*, sim::*), которое собирается и на headless-машинах.
+struct Vec2f {
+    float x = 0.f;
+    float y = 0.f;
+};
+
+constexpr Vec2f operator+(Vec2f a, Vec2f b) { return { a.x + b.x, a.y + b.y }; }
+constexpr Vec2f operator-(Vec2f a, Vec2f b) { return { a.x - b.x, a.y - b.y }; }
+constexpr Vec2f operator*(Vec2f a, float k) { return { a.x * k, a.y * k }; }
+
+#endif //VEC2_HPP
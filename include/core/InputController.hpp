@@ -6,8 +6,9 @@
 #define INPUTCONTROLLER_HPP
 
 #include <SFML/Graphics.hpp>
-#include <vector>
-#include "physics/Ball.hpp"
+#include <box2d/box2d.h>
+#include "physics/BallStore.hpp"
+#include "sim/SimThread.hpp"
 
 namespace core {
 
@@ -19,12 +20,23 @@ namespace core {
             , m_maxImpulse(maxImpulse)
         {}
 
+        /// Ввод работает по снимку стола (физика в своём потоке, см. sim::SimThread).
+        /// true — удар готов, он в \p shot; отправлять его — дело вызывающего.
         bool handleEvent(const sf::Event&,
                          sf::RenderWindow&,
-                         std::vector<physics::Ball>&);
+                         const sim::FrameState&,
+                         sim::Shot& shot);
 
         void drawAim(sf::RenderWindow&) const;
 
+        /// Живой шар, в круг которого попадает точка \p ptMeters (ближайший по центру),
+        /// или -1. Открыто для замеров (billiards_bench).
+        int findBallUnder(const sf::Vector2f& ptMeters,
+                          const physics::BallStore&) const;
+
+        /// Импульс удара по вектору оттяжки, Н·с (sim::shotImpulse с настройками контроллера).
+        b2Vec2 computeImpulse(const sf::Vector2f& dragMeters) const;
+
     private:
         float m_maxDrag;      // метры
         float m_maxImpulse;   // Н·с
@@ -33,12 +45,7 @@ namespace core {
         sf::Vector2f m_startPx{},   // ← точка начала drag-а (пиксели)
                      m_currPx{};    // ← текущий курсор      (пиксели)
 
-        physics::Ball* m_selected = nullptr;
-
-        physics::Ball* findBallUnder(const sf::Vector2f& ptMeters,
-                                            std::vector<physics::Ball>&);
-
-        b2Vec2 computeImpulse(const sf::Vector2f& dragMeters) const;
+        physics::SlotHandle m_selected;   ///< выбранный шар (handle слота World), null — нет
     };
 
 } // namespace core
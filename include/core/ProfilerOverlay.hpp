@@ -0,0 +1,50 @@
+//
+// Оверлей профайлера: таблица зон под счётом (см. prof::Profiler).
+//
+
+#ifndef PROFILEROVERLAY_HPP
+#define PROFILEROVERLAY_HPP
+
+#include <cstdio>
+#include <string>
+#include <SFML/Graphics.hpp>
+#include "prof/Profiler.hpp"
+
+namespace core {
+
+    class ProfilerOverlay {
+    public:
+        explicit ProfilerOverlay(const sf::Font& font)
+        : m_text(font, "", 14)
+        {
+            m_text.setFillColor(sf::Color::White);
+            m_text.setPosition({ 4.f, 40.f });    // под ScoreBoard
+        }
+
+        /// Перестраивает текст не чаще раза в kRefreshFrames кадров — цифры успевают прочитаться,
+        /// а sf::Text не пересобирается каждый кадр.
+        void update(const prof::Profiler& profiler)
+        {
+            if (m_frames++ % kRefreshFrames != 0) return;
+
+            std::string s = "zone               last    avg    max  ms\n";
+            char line[96];
+            for (const prof::ZoneStats& z : profiler.stats()) {
+                std::snprintf(line, sizeof line, "%-16s %6.2f %6.2f %6.2f\n", z.name, z.lastMs, z.avgMs, z.maxMs);
+                s += line;
+            }
+            m_text.setString(s);
+        }
+
+        void draw(sf::RenderWindow& win) const { win.draw(m_text); }
+
+    private:
+        static constexpr int kRefreshFrames = 15;
+
+        sf::Text m_text;
+        int      m_frames = 0;
+    };
+
+} // namespace core
+
+#endif //PROFILEROVERLAY_HPP
@@ -19,6 +19,8 @@ namespace core {
 
 
         void increase() { ++m_score; updateText(); }
+        /// Показать счёт \p score (снимок физики, реплей — в том числе назад при перемотке).
+        void set(int score) { if (score != m_score) { m_score = score; updateText(); } }
 
         void draw(sf::RenderWindow& win) const { win.draw(m_text); }
 
@@ -5,21 +5,28 @@
 #ifndef BALL_HPP
 #define BALL_HPP
 
-#include <SFML/System/Vector2.hpp>
 #include <box2d/box2d.h>
 #include "Utils/Scale.hpp"
 
 namespace physics {
 
+    class World;
+
+    /// Пороги «остановки» шара: ниже них скорости гасятся, тело усыпляется.
+    inline const float kRestLinearSpeed  = px2m(3.f);   // ≈ 3 px/с в м/с
+    inline const float kRestAngularSpeed = 0.01f;       // рад/с
+    /// Линейное демпфирование шара, 1/с (скорость за шаг h умножается на 1/(1 + h·c)).
+    inline const float kBallLinearDamping = 0.9f;
+
     /// Класс Ball для Box2D, где 100 px = 1 m.
     class Ball {
     public:
         ///
-        /// \param world   — ссылка на b2World
+        /// \param world   — мир, в котором шар регистрируется (слот в SoA-зеркале)
         /// \param rPix    — радиус шара в пикселях
         /// \param posPix  — стартовая позиция центра шара в пикселях
         ///
-        Ball(b2World& world, float rPix, const sf::Vector2f& posPix);
+        Ball(World& world, float rPix, const Vec2f& posPix);
 
         // Move semantics: разрешаем перемещение
         Ball(Ball&& other) noexcept;
@@ -33,10 +40,12 @@ namespace physics {
 
         [[nodiscard]] b2Body* body()   const { return m_body; }
         [[nodiscard]] float   radius() const { return m_radiusPx; }
+        [[nodiscard]] int     slot()   const { return m_slot; }
 
     private:
-        b2World&   m_world;     ///< «сырое» поле физики (метры)
+        World&     m_world;     ///< мир физики (метры)
         b2Body*    m_body{};    ///< указатель на тело Box2D
+        int        m_slot = -1; ///< индекс в World::balls()
         float      m_radiusPx;  ///< радиус шара в пикселях
     };
 
@@ -0,0 +1,36 @@
+#ifndef BALLSTORE_HPP
+#define BALLSTORE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace physics {
+
+    /// Плотное SoA-зеркало состояния шаров (structure of arrays).
+    ///
+    /// Индекс — слот шара в World (Ball::slot()). Заполняется один раз за World::step,
+    /// дальше все «горячие» проходы (гашение скоростей, карманы, ввод, рендер) читают
+    /// непрерывные массивы вместо разыменования b2Body* в пуле Box2D.
+    /// Слоты удалённых шаров не сдвигаются — у них alive[i] == 0.
+    struct BallStore {
+        std::vector<float>        x,  y;    ///< центр, м
+        std::vector<float>        vx, vy;   ///< линейная скорость, м/с
+        std::vector<float>        w;        ///< угловая скорость, рад/с
+        std::vector<float>        r;        ///< радиус, м
+        std::vector<std::uint8_t> alive;    ///< 1 — шар на столе
+        std::vector<std::uint8_t> awake;    ///< 1 — тело не спит
+
+        [[nodiscard]] std::size_t size() const { return x.size(); }
+
+        void resize(std::size_t n) {
+            x.resize(n);  y.resize(n);
+            vx.resize(n); vy.resize(n);
+            w.resize(n);  r.resize(n);
+            alive.resize(n); awake.resize(n);
+        }
+    };
+
+} // namespace physics
+
+#endif //BALLSTORE_HPP
@@ -0,0 +1,142 @@
+#ifndef EVENTSOLVER_HPP
+#define EVENTSOLVER_HPP
+
+#include <cstdint>
+#include <queue>
+#include <unordered_map>
+#include <vector>
+#include <box2d/box2d.h>
+
+namespace physics {
+
+    /// Событийный (event-driven) решатель для стола без гравитации.
+    ///
+    /// Между столкновениями шар движется по замкнутой формуле с вязким демпфированием:
+    ///     v(t) = v0·e^(−c·t),   p(t) = p0 + v0·(1 − e^(−c·t)) / c,
+    /// поэтому вместо b2World::Step мы прыгаем сразу от события к событию
+    /// (шар–шар, шар–борт, остановка шара) через очередь с приоритетом.
+    ///
+    /// b2World используется только как хранилище состояния: шары — динамические тела
+    /// с круглой фикстурой, борта — рёбра статических тел, карманы — круглые сенсоры
+    /// статических тел (userData = номер кармана + 1). Вход центра шара в круг кармана —
+    /// такое же событие, поэтому быстрый шар не может «проскочить» карман между кадрами.
+    /// После advance() позиции и скорости записываются обратно в b2Body, так что внешний
+    /// код (рендер, ввод) ничего не замечает. Внешние изменения тел (импульс, SetTransform, удаление)
+    /// подхватываются в начале каждого advance().
+    ///
+    /// Допущения: все шары имеют одинаковое линейное демпфирование (как у physics::Ball),
+    /// трение о борт и передача вращения не моделируются.
+    class EventSolver {
+    public:
+        explicit EventSolver(b2World& world) : m_world(world) {}
+
+        EventSolver(const EventSolver&)            = delete;
+        EventSolver& operator=(const EventSolver&) = delete;
+
+        /// Продвигает стол на \p dt секунд, обрабатывая все события внутри интервала.
+        void advance(float dt);
+
+        /// Сколько событий (столкновений и остановок) обработано с момента создания.
+        [[nodiscard]] std::uint64_t eventsProcessed() const { return m_events; }
+
+        /// Центр шара вошёл в круг кармана с номером \p pocket.
+        struct PocketHit {
+            b2Body* body;
+            int     pocket;
+        };
+
+        /// Попадания в карманы с последнего clearPocketHits().
+        [[nodiscard]] const std::vector<PocketHit>& pocketHits() const { return m_pocketHits; }
+        void clearPocketHits() { m_pocketHits.clear(); }
+
+    private:
+        struct BallState {
+            b2Body*  body    = nullptr;
+            double   t0      = 0.0;     ///< момент, к которому относятся p0/v0
+            b2Vec2   p0      {0.f, 0.f};
+            b2Vec2   v0      {0.f, 0.f};
+            float    angle0  = 0.f;
+            float    w0      = 0.f;
+            float    radius  = 0.f;
+            float    damping = 0.f;     ///< линейное демпфирование c
+            float    angDamp = 0.f;
+            float    invMass = 0.f;
+            float    restitution = 0.f;
+            double   restAt  = 0.0;     ///< момент остановки (∞, если уже стоит)
+            uint32_t version = 0;       ///< растёт при каждом изменении траектории
+            bool     alive   = false;
+
+            // То, что мы последний раз записали в тело: по расхождению видим внешние правки
+            b2Vec2   writtenP{0.f, 0.f};
+            b2Vec2   writtenV{0.f, 0.f};
+            float    writtenW = 0.f;
+        };
+
+        struct Wall {
+            b2Vec2 a, t, n;     ///< начало, единичное направление, единичная нормаль
+            float  length;
+        };
+
+        struct PocketZone {
+            b2Vec2 center;
+            float  radius;
+            int    index;       ///< номер кармана (userData − 1)
+        };
+
+        /// Статическое тело на прошлом шаге: новое тело, сдвиг или новая фикстура
+        /// (CreateFixture ставит её в голову списка) меняют ключ.
+        struct StaticKey {
+            b2Body*    body;
+            b2Fixture* fixtures;
+            b2Vec2     position;
+            float      angle;
+        };
+
+        enum class EventType : uint8_t { BallBall, BallWall, Rest, PocketEnter };
+
+        struct Event {
+            double    time;
+            EventType type;
+            int       a, b;             ///< индексы шаров (b — шар, стенка или карман)
+            uint32_t  versionA, versionB;
+
+            bool operator>(const Event& o) const { return time > o.time; }
+        };
+
+        void syncFromWorld();
+        void collectStatics();
+        int  addBall(b2Body* body);
+        void resetBall(int i);
+
+        /// Позиция/скорость шара \p i в момент \p t по замкнутой формуле.
+        void stateAt(const BallState& s, double t, b2Vec2& p, b2Vec2& v) const;
+        void moveTo(int i, double t);
+
+        void predict(int i);
+        void predictPair(int i, int j);
+        void predictWall(int i, int w);
+        void predictPocket(int i, int k);
+
+        void resolveBallBall(int i, int j);
+        void resolveBallWall(int i, int w);
+
+        void writeBack();
+
+        b2World&                 m_world;
+        std::vector<BallState>   m_balls;
+        std::vector<int>         m_freeSlots;
+        std::vector<Wall>        m_walls;
+        std::vector<PocketZone>  m_pockets;
+        std::vector<PocketHit>   m_pocketHits;
+        std::vector<StaticKey>   m_statics;   // ключи статических тел, из них m_walls/m_pockets
+        std::vector<char>        m_seen;      // шары, найденные в мире на этом шаге
+        std::unordered_map<const b2Body*, int> m_index;
+
+        std::priority_queue<Event, std::vector<Event>, std::greater<>> m_queue;
+        double                   m_now    = 0.0;
+        std::uint64_t            m_events = 0;
+    };
+
+} // namespace physics
+
+#endif //EVENTSOLVER_HPP
@@ -0,0 +1,37 @@
+#ifndef POCKETKERNEL_HPP
+#define POCKETKERNEL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "physics/BallStore.hpp"
+#include "physics/Pockets.hpp"
+
+namespace physics {
+
+    /// Пакетная проверка карманов: бит i в \p out выставлен, если центр шара
+    /// (\p xs[i], \p ys[i]) в метрах лежит внутри хотя бы одного кармана — то же условие,
+    /// что и inPocket(), но сразу для всех шаров и всех карманов.
+    ///
+    /// \param alive — маска живых слотов (nullptr — все живые), как BallStore::alive
+    /// \param out   — не меньше (n + 63) / 64 слов; перезаписывается целиком
+    ///
+    /// Путь выбирается при компиляции по glm/simd/platform.h: AVX2 (8 шаров за раз),
+    /// SSE2 (4 шара) или скалярный.
+    void pottedMask(const float* xs, const float* ys, const std::uint8_t* alive, std::size_t n,
+                    const std::vector<Pocket>& pockets, std::uint64_t* out);
+
+    /// То же для SoA-зеркала мира; \p out подгоняется под число слотов.
+    void pottedMask(const BallStore& balls, const std::vector<Pocket>& pockets,
+                    std::vector<std::uint64_t>& out);
+
+    inline bool testBit(const std::vector<std::uint64_t>& mask, std::size_t i) {
+        return (mask[i >> 6] >> (i & 63)) & 1u;
+    }
+
+    /// Каким набором инструкций собрано ядро: "avx2", "sse2" или "scalar".
+    const char* pocketKernelIsa();
+
+} // namespace physics
+
+#endif //POCKETKERNEL_HPP
@@ -5,13 +5,14 @@
 #ifndef POCKETS_HPP
 #define POCKETS_HPP
 
-#include <SFML/System/Vector2.hpp>
 #include <vector>
+#include "physics/Ball.hpp"
+#include "Utils/Scale.hpp"
 
 namespace physics {
 
     struct Pocket {
-        sf::Vector2f center;
+        Vec2f        center;
         float        radius;
     };
 
@@ -31,6 +32,14 @@ namespace physics {
                     {{ w-off,  h-off  }, r}   // правый нижний угол
         };
     }
+        /// Центр шара (\p xM, \p yM в метрах) внутри круга кармана?
+        inline bool inPocket(const physics::Pocket& p, float xM, float yM)
+        {
+            float dx = xM - p.center.x;
+            float dy = yM - p.center.y;
+            return (dx * dx + dy * dy) <= (p.radius * p.radius);
+        }
+
         inline bool inPocket(const physics::Pocket& p, const physics::Ball& b)
         {
             // Центр шара в метрах
@@ -0,0 +1,124 @@
+#ifndef SLOTMAP_HPP
+#define SLOTMAP_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace physics {
+
+    /// Ссылка на элемент SlotMap (или на слот World): индекс + поколение.
+    /// После удаления элемента поколение слота растёт, и старый handle перестаёт
+    /// разрешаться — вместо висячего указателя получаем nullptr / -1.
+    struct SlotHandle {
+        std::uint32_t index      = UINT32_MAX;
+        std::uint32_t generation = 0;
+
+        [[nodiscard]] bool isNull() const { return index == UINT32_MAX; }
+        bool operator==(const SlotHandle&) const = default;
+    };
+
+    /// Контейнер со стабильными handle'ами: вставка и удаление O(1), значения лежат
+    /// плотно в одном векторе (итерация без дыр и без проверок «жив ли»).
+    ///
+    /// Удаление переносит последний элемент на место удалённого (swap-remove), поэтому
+    /// порядок итерации не сохраняется, а указатели на значения живут только до
+    /// следующего erase/emplace — долгоживущие ссылки держат SlotHandle.
+    template <class T>
+    class SlotMap {
+    public:
+        template <class... Args>
+        SlotHandle emplace(Args&&... args)
+        {
+            std::uint32_t s;
+            if (!m_free.empty()) {
+                s = m_free.back();
+                m_free.pop_back();
+            } else {
+                s = static_cast<std::uint32_t>(m_slots.size());
+                m_slots.push_back({});
+            }
+            m_slots[s].dense = static_cast<std::uint32_t>(m_values.size());
+            m_values.emplace_back(std::forward<Args>(args)...);
+            m_denseToSlot.push_back(s);
+            return { s, m_slots[s].generation };
+        }
+
+        /// Удаляет элемент; false, если handle уже недействителен.
+        bool erase(SlotHandle h)
+        {
+            if (!contains(h)) return false;
+            const std::uint32_t d    = m_slots[h.index].dense;
+            const std::uint32_t last = static_cast<std::uint32_t>(m_values.size() - 1);
+            if (d != last) {
+                m_values[d]      = std::move(m_values[last]);
+                m_denseToSlot[d] = m_denseToSlot[last];
+                m_slots[m_denseToSlot[d]].dense = d;
+            }
+            m_values.pop_back();
+            m_denseToSlot.pop_back();
+
+            ++m_slots[h.index].generation;
+            m_free.push_back(h.index);
+            return true;
+        }
+
+        void clear()
+        {
+            for (std::uint32_t s : m_denseToSlot) {
+                ++m_slots[s].generation;
+                m_free.push_back(s);
+            }
+            m_values.clear();
+            m_denseToSlot.clear();
+        }
+
+        void reserve(std::size_t n)
+        {
+            m_values.reserve(n);
+            m_denseToSlot.reserve(n);
+            m_slots.reserve(n);
+        }
+
+        [[nodiscard]] bool contains(SlotHandle h) const
+        {
+            // Поколение слота растёт при каждом удалении — совпадение значит «тот же элемент»
+            return h.index < m_slots.size() && m_slots[h.index].generation == h.generation;
+        }
+
+        /// Значение по handle или nullptr, если элемент уже удалён.
+        [[nodiscard]] T*       get(SlotHandle h)       { return contains(h) ? &m_values[m_slots[h.index].dense] : nullptr; }
+        [[nodiscard]] const T* get(SlotHandle h) const { return contains(h) ? &m_values[m_slots[h.index].dense] : nullptr; }
+
+        /// Handle элемента, лежащего на позиции \p denseIndex плотного массива.
+        [[nodiscard]] SlotHandle handleAt(std::size_t denseIndex) const
+        {
+            const std::uint32_t s = m_denseToSlot[denseIndex];
+            return { s, m_slots[s].generation };
+        }
+
+        [[nodiscard]] std::size_t size()  const { return m_values.size(); }
+        [[nodiscard]] bool        empty() const { return m_values.empty(); }
+
+        // Плотная итерация по значениям
+        auto begin()       { return m_values.begin(); }
+        auto end()         { return m_values.end(); }
+        auto begin() const { return m_values.begin(); }
+        auto end()   const { return m_values.end(); }
+
+    private:
+        struct Slot {
+            std::uint32_t dense      = 0;   ///< позиция в m_values
+            std::uint32_t generation = 0;
+        };
+
+        std::vector<T>             m_values;
+        std::vector<std::uint32_t> m_denseToSlot;
+        std::vector<Slot>          m_slots;
+        std::vector<std::uint32_t> m_free;
+    };
+
+} // namespace physics
+
+#endif //SLOTMAP_HPP
@@ -31,6 +31,7 @@ namespace physics {
             bd.type = b2_staticBody;
             bd.position.Set(0.0f, 0.0f);
             b2Body* walls = world.CreateBody(&bd);
+            m_body = walls;
 
             // Лямбда для упрощения: создаёт EdgeShape от (x1,y1) до (x2,y2) в метрах.
             auto makeEdge = [&](float x1, float y1, float x2, float y2) {
@@ -49,6 +50,12 @@ namespace physics {
             // 4) Правая грань
             makeEdge(right,  top,    right,  bottom);
         }
+
+        /// Статическое тело бортов (на нём же висят сенсоры карманов, см. World::addPockets)
+        [[nodiscard]] b2Body* body() const { return m_body; }
+
+    private:
+        b2Body* m_body = nullptr;
     };
 
 } // namespace physics
@@ -5,29 +5,200 @@
 #ifndef WORLD_HPP
 #define WORLD_HPP
 
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <type_traits>
+#include <vector>
 #include <box2d/box2d.h>
+#include "physics/BallStore.hpp"
+#include "physics/EventSolver.hpp"
+#include "physics/Pockets.hpp"
+#include "physics/SlotMap.hpp"
 
 namespace physics {
 
+    /// Чем продвигать стол во времени.
+    enum class Backend {
+        Box2D,      ///< b2World::Step — итеративный решатель контактов
+        Analytic    ///< EventSolver — точные события шар–шар / шар–борт по замкнутым формулам
+    };
+
+    /// Шар \p slot попал в карман \p pocket (центр внутри круга кармана).
+    struct PocketEvent {
+        int slot;
+        int pocket;
+    };
+
+    /// Состояние одного слота в снимке. POD без указателей: снимок копируется memcpy.
+    struct BallSnapshot {
+        float        x, y, angle;   ///< м, рад
+        float        vx, vy, w;     ///< м/с, рад/с
+        std::uint8_t alive;         ///< 1 — шар на столе (0 — забит, тело выключено)
+        std::uint8_t awake;
+    };
+    static_assert(std::is_trivially_copyable_v<BallSnapshot>);
+
+    /// Снимок стола: по элементу на каждый слот World::balls().
+    /// Буфер переиспользуется — повторный snapshot() в тот же объект не выделяет память.
+    struct WorldSnapshot {
+        std::vector<BallSnapshot> balls;
+    };
+
     /// Обёртка вокруг b2World (API 2.4.1)
     class World {
     public:
         /// Конструктор: мир без гравитации (гравитация = (0,0))
-        World()
-            : m_world(b2Vec2(0.0f, 0.0f))
-        {}
-
-        /// Шаг симуляции (dt в секундах)
-        void step(float dt) {
-            // velocityIterations = 8, positionIterations = 3 (типичные значения)
-            m_world.Step(dt, 8, 3);
-        }
+        explicit World(Backend backend = Backend::Box2D);
+        ~World();
+
+        World(const World&)            = delete;
+        World& operator=(const World&) = delete;
+
+        /// Шаг симуляции (dt в секундах); в конце шага обновляет SoA-зеркало balls()
+        void step(float dt);
 
         /// Возвращает «сырое» b2World для прямого доступа (например, GetBodyList)
         b2World& raw() { return m_world; }
 
+        // ─── Реестр шаров (вызывается из Ball) ───────────────────────
+
+        /// Регистрирует тело шара радиуса \p radiusM (м), возвращает его слот.
+        int  addBall(b2Body* body, float radiusM);
+        /// Удаляет тело шара из b2World и освобождает слот.
+        void removeBall(int slot);
+        /// Снимает шар со стола, не разрушая тело (b2Body::SetEnabled(false)):
+        /// слот остаётся занят, и restore() может вернуть шар обратно.
+        void pot(int slot);
+
+        /// Handle слота: переживает pot()/restore(), но не removeBall() — после удаления
+        /// (и повторного занятия слота другим шаром) resolve() вернёт -1.
+        [[nodiscard]] SlotHandle handle(int slot) const {
+            return { static_cast<std::uint32_t>(slot), m_generations[slot] };
+        }
+        /// Слот по handle или -1, если шар уже удалён.
+        [[nodiscard]] int resolve(SlotHandle h) const {
+            return (h.index < m_bodies.size() && m_bodies[h.index] && m_generations[h.index] == h.generation)
+                   ? static_cast<int>(h.index) : -1;
+        }
+
+        /// SoA-состояние всех слотов на конец последнего шага.
+        [[nodiscard]] const BallStore& balls() const { return m_balls; }
+        [[nodiscard]] b2Body*          body(int slot) const { return m_bodies[slot]; }
+
+        // ─── Изменения шаров снаружи шага: тело и SoA меняются вместе ─
+
+        /// Импульс в центр шара (Н·с), будит тело.
+        void applyImpulse(int slot, const b2Vec2& impulse);
+        /// Переставляет шар в точку \p posM (м) и останавливает его.
+        void teleport(int slot, const b2Vec2& posM);
+
+        /// Гасит скорости ниже порогов (\p vEps м/с, \p wEps рад/с); если обе
+        /// скорости малы — усыпляет тело. Пороговый проход идёт по SoA-массивам.
+        void settle(float vEps, float wEps);
+
+        /// Все живые шары стоят (скорости не выше порогов).
+        [[nodiscard]] bool atRest(float vEps, float wEps) const;
+
+        /// Наибольшая линейная скорость среди живых шаров, м/с (проход по SoA).
+        [[nodiscard]] float maxSpeed() const;
+
+        // ─── Покой стола ─────────────────────────────────────────────
+
+        /// Сколько живых шаров не спит. Счётчик ведётся при каждой смене флага awake,
+        /// без прохода по шарам.
+        [[nodiscard]] int awakeCount() const { return m_awakeCount; }
+
+        /// Все шары спят: step() ничего не делает, atRest()/settle()/maxSpeed()
+        /// отвечают сразу. Выход из покоя — только через внешнее изменение тела.
+        [[nodiscard]] bool idle() const { return m_awakeCount == 0; }
+
+        /// Колбэк на переход «что-то движется → стол в покое» (по фронту, один раз
+        /// на каждое успокоение). Вызывается изнутри step()/settle()/restore()/...
+        void setRestCallback(std::function<void()> onRest) { m_onRest = std::move(onRest); }
+
+        // ─── Снимки состояния ────────────────────────────────────────
+
+        /// Копирует позиции, скорости, флаги alive/awake всех слотов в \p out.
+        /// Тела не создаются и не удаляются — только чтение SoA и угла тела.
+        void snapshot(WorldSnapshot& out) const;
+        [[nodiscard]] WorldSnapshot snapshot() const;
+
+        /// Возвращает стол в состояние \p snap: включает/выключает тела забитых шаров,
+        /// переставляет и раскручивает остальные. Снимок должен быть сделан с этого же
+        /// World; слоты, освобождённые removeBall() после снимка, пропускаются.
+        /// Накопленные контакты Box2D (warm starting) не сохраняются, поэтому повтор
+        /// после restore() близок к исходному прогону, но не совпадает с ним бит в бит.
+        void restore(const WorldSnapshot& snap);
+
+        // ─── Хеш состояния ───────────────────────────────────────────
+
+        /// Скользящий хеш истории стола: каждое mixStateHash() подмешивает в него
+        /// x, y, vx, vy, w, alive всех слотов побитово. Два прогона с одинаковыми
+        /// входами дают одинаковый хеш на каждом тике; первый же отличающийся бит
+        /// меняет его навсегда (шаг смешивания обратим). snapshot()/restore() его
+        /// не трогают — это история, а не состояние.
+        [[nodiscard]] std::uint64_t stateHash() const { return m_stateHash; }
+        /// Подмешать текущее состояние (Simulation зовёт в конце каждого тика).
+        void mixStateHash();
+
+        // ─── Карманы ─────────────────────────────────────────────────
+
+        /// Вешает карманы сенсорными фикстурами на статическое тело \p table.
+        /// Касание сенсора (BeginContact) делает шар «кандидатом»; точная проверка
+        /// inPocket идёт после каждого подшага только для кандидатов.
+        void addPockets(b2Body* table, const std::vector<Pocket>& pockets);
+
+        /// Попадания в карманы, накопленные с последнего clearPocketEvents().
+        /// Один шар встречается не больше одного раза.
+        [[nodiscard]] const std::vector<PocketEvent>& pocketEvents() const { return m_pocketEvents; }
+        void clearPocketEvents() { m_pocketEvents.clear(); }
+
+        [[nodiscard]] Backend backend() const { return m_backend; }
+
+        /// Число обработанных событий (только для Backend::Analytic, иначе 0).
+        [[nodiscard]] std::uint64_t eventsProcessed() const {
+            return m_solver ? m_solver->eventsProcessed() : 0;
+        }
+
     private:
-        b2World m_world;
+        /// Слушатель контактов Box2D: пары (шар, карман), где шар касается сенсора.
+        class PocketContacts : public b2ContactListener {
+        public:
+            void BeginContact(b2Contact* contact) override;
+            void EndContact(b2Contact* contact) override;
+
+            std::vector<std::pair<int, int>> near;   ///< (слот, карман)
+        };
+
+        /// Перечитывает состояние одного слота из его b2Body.
+        void syncSlot(int slot);
+        void syncBalls();
+        /// Единственное место, где меняется awake[]: держит m_awakeCount в актуальном виде.
+        void setAwakeFlag(int slot, std::uint8_t awake);
+        /// Проверяет переход в покой и дёргает m_onRest по фронту.
+        void updateRestState();
+        void checkPockets();
+        void reportPocket(int slot, int pocket);
+
+        b2World                      m_world;
+        Backend                      m_backend;
+        std::unique_ptr<EventSolver> m_solver;   // только для Backend::Analytic
+
+        BallStore                    m_balls;
+        std::vector<b2Body*>         m_bodies;   // тело каждого слота (nullptr — слот свободен)
+        std::vector<int>             m_freeSlots;
+        std::vector<std::uint32_t>   m_generations;   // растёт при removeBall
+        std::vector<std::uint8_t>    m_settleMask;
+
+        std::uint64_t                m_stateHash  = 0xcbf29ce484222325ull;   // FNV offset basis
+        int                          m_awakeCount = 0;
+        bool                         m_idle       = true;
+        std::function<void()>        m_onRest;
+
+        std::vector<Pocket>          m_pockets;
+        PocketContacts               m_contacts;
+        std::vector<PocketEvent>     m_pocketEvents;
     };
 
 }
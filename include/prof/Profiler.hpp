@@ -0,0 +1,120 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace prof {
+
+    using Clock = std::chrono::steady_clock;
+
+    /// Сводка по зоне за последние Profiler::kWindow кадров.
+    struct ZoneStats {
+        const char* name;
+        float       lastMs;    ///< сумма за последний кадр
+        float       avgMs;
+        float       maxMs;
+    };
+
+    /// Покадровый профайлер: зоны из любых потоков, кадр закрывает поток рендера.
+    ///
+    /// Зоны (PROFILE_ZONE) пишутся в общий список текущего кадра; endFrame() суммирует
+    /// их по имени в скользящее окно для оверлея и, если открыты, дописывает строки в
+    /// CSV и события в Chrome trace (chrome://tracing, ui.perfetto.dev).
+    /// Пока профайлер выключен (setEnabled), record() сразу выходит — billiards_sim
+    /// и ShotEvaluator с тем же ядром ничего не копят.
+    ///
+    /// Имена зон — строковые литералы: хранится указатель, не копия.
+    class Profiler {
+    public:
+        static constexpr int kWindow = 120;   ///< кадров в скользящем окне
+
+        static Profiler& instance();
+
+        void setEnabled(bool on) { m_enabled.store(on, std::memory_order_relaxed); }
+        [[nodiscard]] bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+        /// Открыть файлы выгрузки (и включить профайлер). false — файл не открылся.
+        bool openCsv(const std::string& path);
+        bool openChromeTrace(const std::string& path);
+
+        /// Интервал [begin, end) зоны \p name из текущего потока.
+        void record(const char* name, Clock::time_point begin, Clock::time_point end);
+        /// Готовое значение в мс без отметок времени (таймеры GPU приходят так).
+        void recordValue(const char* name, double ms);
+
+        /// Закрыть кадр: обновить окно статистики и выгрузить события.
+        void endFrame();
+
+        /// Статистика по всем зонам, встреченным с начала работы, в порядке появления.
+        [[nodiscard]] std::vector<ZoneStats> stats() const;
+
+    private:
+        Profiler();
+        ~Profiler();
+
+        struct Event {
+            const char*   name;
+            std::uint32_t thread;
+            std::int64_t  beginUs;   // от m_epoch
+            double        ms;
+            bool          value;     // recordValue: только число, без интервала
+        };
+
+        struct Rolling {
+            const char*                 name;
+            std::array<float, kWindow>  ms{};
+            float                       last = 0.f;
+        };
+
+        static std::uint32_t threadIndex();
+        Rolling& zone(const char* name);
+
+        std::atomic<bool>    m_enabled{ false };
+        Clock::time_point    m_epoch;
+        std::uint64_t        m_frame = 0;
+
+        mutable std::mutex   m_mutex;        // m_events пишут все потоки
+        std::vector<Event>   m_events, m_closing;
+        std::vector<Rolling> m_zones;        // только поток рендера
+        std::vector<float>   m_frameSum;
+
+        std::ofstream        m_csv, m_trace;
+        bool                 m_traceEmpty = true;
+    };
+
+    /// RAII-зона: меряет время жизни объекта.
+    class Zone {
+    public:
+        explicit Zone(const char* name) : m_name(name), m_begin(Clock::now()) {}
+        ~Zone() { Profiler::instance().record(m_name, m_begin, Clock::now()); }
+
+        Zone(const Zone&)            = delete;
+        Zone& operator=(const Zone&) = delete;
+
+    private:
+        const char*       m_name;
+        Clock::time_point m_begin;
+    };
+
+} // namespace prof
+
+// Зоны есть только в профилирующих сборках (-DBILLIARDS_PROFILE, Debug — всегда);
+// в релизе макросы разворачиваются в пустую инструкцию.
+#if defined(BILLIARDS_PROFILE)
+#   define PROF_CONCAT_(a, b) a##b
+#   define PROF_CONCAT(a, b)  PROF_CONCAT_(a, b)
+#   define PROFILE_ZONE(name) ::prof::Zone PROF_CONCAT(profZone_, __LINE__){ name }
+#   define PROFILE_FRAME()    ::prof::Profiler::instance().endFrame()
+#else
+#   define PROFILE_ZONE(name) do {} while (0)
+#   define PROFILE_FRAME()    do {} while (0)
+#endif
+
+#endif //PROFILER_HPP
@@ -1,13 +1,17 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
 #include <string>
 #include <vector>
 #include <SFML/Window.hpp>
 #include <SFML/Graphics.hpp>
 #include <glm/glm.hpp>
 #include <box2d/box2d.h>
-#include "physics/Ball.hpp"
+#include "physics/BallStore.hpp"
 #include "physics/Pockets.hpp"
+#include "render/MeshBuilder.hpp"
+#include "render/ShaderProgram.hpp"
 
 // Мы предполагаем, что glad уже подключён глобально в проекте
 // (в main.cpp или CMakeLists.txt настроены include-директории).
@@ -15,40 +19,80 @@
 
 namespace render {
 
+/// Как рисовать шары.
+enum class BallMode {
+    Mesh,       ///< треугольные сферы с LOD (createSphereMesh)
+    Impostor    ///< квадрат к камере + трассировка сферы во фрагментном шейдере
+};
+
 class GLRenderer {
 public:
     /// Компилирует шейдеры, создаёт VAO/VBO/IBO для сферы и стола.
-    /// \param shaderDir путь до папки, где лежат файлы "phong.vert" и "phong.frag"
-    bool init(const std::string& shaderDir);
+    /// \param shaderDir путь до папки с "phong.vert/.frag" и "impostor.vert/.frag"
+    /// \param cacheDir  папка для кэша бинарников программ; пустая — всегда компилировать
+    bool init(const std::string& shaderDir, const std::string& cacheDir = {});
 
     /// Обновляет соотношение сторон для матрицы проекции (вызывается при старте и ресайзе).
     void resize(int w, int h);
 
     /// Рисует всю 3D-сцену: стол, борта, шары, карманы.
-    /// \param balls   — вектор шаров (Box2D), у каждого можно взять позицию (метры) и радиус (px).
+    /// Перед кадром проверяет, не поменялись ли шейдеры на диске (см. ShaderProgram).
+    /// Шары рисуются glDrawElementsInstanced по одному вызову на уровень детализации:
+    /// центр и радиус каждого шара уходят в буфер экземпляров (m_vboInstances),
+    /// уровень выбирается по радиусу шара на экране (см. pickLod).
+    /// \param balls   — SoA-состояние шаров из World::balls() (позиция и радиус в метрах).
     /// \param pockets — список карманов (их центр и радиус уже в метрах).
-    /// \param tableWpx — ширина стола в пикселях (1280).
-    /// \param tableHpx — высота стола в пикселях (720).
-    void drawScene(const std::vector<physics::Ball>&    balls,
+    /// \param tableWpx — ширина стола в пикселях (1280); меш стола центрирован, шары сдвигаются на −W/2.
+    /// \param tableHpx — высота стола в пикселях (720); аналогично −H/2.
+    void drawScene(const physics::BallStore&           balls,
                    const std::vector<physics::Pocket>& pockets,
                    float tableWpx,
                    float tableHpx);
 
+    /// То же, но шары — между двумя шагами физики: lerp(\p prev, \p curr, \p alpha).
+    /// \p alpha — остаток аккумулятора фиксированного шага в долях шага
+    /// (FixedStepClock::alpha, SimThread::alpha). Частоту физики можно держать ниже
+    /// частоты кадров — движение всё равно плавное. Слот, которого в \p prev нет
+    /// (или который за шаг «телепортировался», например биток из лузы), рисуется по \p curr.
+    void drawScene(const physics::BallStore&           prev,
+                   const physics::BallStore&           curr,
+                   float alpha,
+                   const std::vector<physics::Pocket>& pockets,
+                   float tableWpx,
+                   float tableHpx);
+
+    /// Число draw call'ов и треугольников в последнем drawScene (для замеров).
+    [[nodiscard]] int  lastDrawCalls() const { return m_drawCalls; }
+    [[nodiscard]] long lastTriangles() const { return m_triangles; }
+
+    /// Режим отрисовки шаров; переключается между кадрами.
+    void     setBallMode(BallMode mode) { m_ballMode = mode; }
+    [[nodiscard]] BallMode ballMode() const { return m_ballMode; }
+
+    /// Расстояние камеры до центра стола, м.
+    void setCameraDistance(float dist) { m_dist = dist; }
+
 private:
     // Приватные вспомогательные методы:
 
-    /// Компилирует шейдер из текста `src` типа `type` (GL_VERTEX_SHADER или GL_FRAGMENT_SHADER).
-    /// Возвращает ноль, если ошибка, иначе ID шейдера.
-    unsigned int compileShader(const char* src, unsigned int type);
+    /// Генерирует цепочку единичных UV-сфер с детализацией из m_lods — все уровни
+    /// в одном VBO/IBO, диапазоны индексов в m_lods. Заполняет m_vaoSphere,
+    /// m_vboSphere, m_iboSphere, m_indexType и подключает к m_vaoSphere буфер
+    /// экземпляров m_vboInstances (атрибут 2, divisor 1).
+    void createSphereMesh();
 
-    /// Линкует вершинный (vs) и фрагментный (fs) шейдеры в одну программу.
-    /// Возвращает ID программы или 0 при ошибке.
-    unsigned int linkProgram(unsigned int vs, unsigned int fs);
+    /// Квадрат (±1, ±1) для импосторов; к m_vaoQuad подключается тот же
+    /// буфер экземпляров m_vboInstances (атрибут 2, divisor 1).
+    void createQuadMesh();
 
+    /// Уровень детализации для шара радиуса \p radius на расстоянии \p distance от камеры.
+    int pickLod(float radius, float distance) const;
 
-    /// Генерирует меш сферы (VBO/IBO). \p radius — радиус в метрах, \p rings и \p sectors
-    /// определяют детализацию. Заполняет m_vaoSphere, m_vboSphere, m_iboSphere, m_indexCount.
-    void createSphereMesh(float radius, int rings, int sectors);
+    /// Заливает центры/радиусы живых шаров curr (интерполированные от prev на alpha)
+    /// в m_vboInstances, сгруппировав их по уровням детализации (m_lodFirst/m_lodCount).
+    /// \p eye — позиция камеры. Возвращает число шаров.
+    int uploadInstances(const physics::BallStore& prev, const physics::BallStore& curr, float alpha,
+                        float offsetX, float offsetZ, const glm::vec3& eye);
 
     /// Генерирует меш стола и бортов. \p wPx и \p hPx — размеры стола в пикселях,
     /// \p hBorderPx — высота борта в пикселях. Заполняет m_vaoTable, m_vboTable.
@@ -58,17 +102,38 @@ private:
 
 private:
     // OpenGL-объекты:
-    unsigned int m_program      = 0;
+    ShaderProgram m_phong;             // phong.vert/frag, перечитывается при правке на диске
+    ShaderProgram m_impostor;          // impostor.vert/frag — шары в режиме BallMode::Impostor
+    BallMode      m_ballMode = BallMode::Mesh;
     unsigned int m_vaoSphere    = 0;
     unsigned int m_vboSphere    = 0;
     unsigned int m_iboSphere    = 0;
-    int          m_indexCount   = 0;
+    unsigned int m_indexType    = GL_UNSIGNED_INT;   // GL_UNSIGNED_SHORT, если вершин ≤ 65536
+    std::size_t  m_indexSize    = 4;
+
+    // Уровни детализации сферы (SphereVertex, SphereLod — MeshBuilder.hpp): от грубого к подробному
+    static constexpr int kLodCount = 4;
+    std::array<SphereLod, kLodCount> m_lods{{ {4, 8}, {8, 16}, {16, 32}, {32, 64} }};
+
+    // Буфер экземпляров шаров: vec4(центр.xyz, радиус) на шар
+    unsigned int           m_vboInstances     = 0;
+    std::size_t            m_instanceCapacity = 0;   // в экземплярах
+    std::vector<glm::vec4> m_instances;
+    std::vector<glm::vec4> m_unsorted;                // кадр до группировки по уровням
+    std::vector<std::uint8_t> m_instanceLod;
+    std::array<int, kLodCount> m_lodFirst{}, m_lodCount{};
+    int                    m_drawCalls        = 0;
+    long                   m_triangles        = 0;
+
+    unsigned int m_vaoQuad      = 0;
+    unsigned int m_vboQuad      = 0;
 
     unsigned int m_vaoTable     = 0;
     unsigned int m_vboTable     = 0;
 
     // Параметры камеры/матриц:
     float m_aspect = 1.0f;
+    int   m_viewportH = 720;   // высота окна, px — для экранного радиуса шаров
     float m_yaw    = 25.f;     // угол вокруг Y
     float m_pitch  = -45.f;    // угол вокруг X
     float m_dist   = 8.f;      // расстояние камеры до центра
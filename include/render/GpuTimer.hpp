@@ -0,0 +1,38 @@
+#pragma once
+
+#include <array>
+#include <glad/glad.h>
+
+namespace render {
+
+/// Время GPU на участке кадра через GL_TIME_ELAPSED (ARB_timer_query, ядро 3.3).
+///
+/// Результат запроса готов через кадр-другой после glEndQuery, поэтому запросов
+/// кольцо из kQueries: begin() перед новым замером забирает готовый результат
+/// самого старого. Ждать GPU не приходится — цифра отстаёт на несколько кадров.
+class GpuTimer {
+public:
+    GpuTimer() = default;
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&)            = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void begin();
+    void end();
+
+    /// Последний готовый замер, мс. false — готовых ещё не было.
+    bool latest(double& ms) const;
+
+private:
+    static constexpr int    kQueries        = 4;
+    static constexpr double kMaxPlausibleMs = 1000.0;   ///< дольше секунды кадр GPU не считаем
+
+    std::array<GLuint, kQueries> m_queries{};
+    std::array<bool, kQueries>   m_pending{};
+    int    m_next    = 0;
+    double m_lastMs  = 0.0;
+    bool   m_hasLast = false;
+};
+
+} // namespace render
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace render {
+
+/// Вершина сферы, 12 байт вместо 24: позиция snorm16×3 (+ выравнивание),
+/// нормаль snorm 10:10:10:2. Радиус всё равно приходит из буфера экземпляров.
+struct SphereVertex {
+    std::int16_t  px, py, pz, pad = 0;
+    std::uint32_t normal;
+};
+static_assert(sizeof(SphereVertex) == 12);
+
+/// Уровень детализации сферы; диапазон индексов и ACMR заполняет buildSphereMesh.
+struct SphereLod {
+    int   rings, sectors;
+    int   firstIndex = 0;      // смещение в общем списке индексов
+    int   indexCount = 0;
+    float acmrBefore = 0.f;    // ACMR до и после перестановки треугольников
+    float acmrAfter  = 0.f;
+};
+
+/// CPU-часть GLRenderer::createSphereMesh: единичные UV-сферы всех уровней \p lods
+/// подряд в \p vertices / \p indices (оба очищаются). Индексы уже сдвинуты на начало
+/// вершин своего уровня, треугольники каждого уровня переставлены под кэш вершин.
+/// Без OpenGL — годится и для замеров (billiards_bench).
+void buildSphereMesh(std::span<SphereLod> lods,
+                     std::vector<SphereVertex>& vertices,
+                     std::vector<std::uint32_t>& indices);
+
+/// CPU-часть GLRenderer::createTableMesh: плоскость стола и четыре борта,
+/// по 3 float (x, y, z в метрах) на вершину, треугольники списком. Стол центрирован,
+/// \p wPx × \p hPx — размеры в пикселях, \p hBorderPx — высота борта. \p data очищается.
+void buildTableMesh(float wPx, float hPx, float hBorderPx, std::vector<float>& data);
+
+} // namespace render
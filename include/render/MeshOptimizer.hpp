@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace render {
+
+/// Размер FIFO-кэша вершин после трансформации, под который оптимизируем и по
+/// которому считаем ACMR. 16–32 — типично для десктопных GPU; llvmpipe тоже
+/// переиспользует уже обработанные вершины в пределах пачки.
+constexpr std::size_t kVertexCacheSize = 16;
+
+/// Переставляет треугольники списка \p indices (по 3 индекса) так, чтобы соседние
+/// треугольники чаще делили вершины, уже лежащие в кэше (алгоритм Форсайта,
+/// «Linear-Speed Vertex Cache Optimisation»). Сами вершины не трогает.
+/// \p vertexCount — верхняя граница индексов (максимальный индекс + 1).
+void optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount);
+
+/// Average Cache Miss Ratio: промахи FIFO-кэша размера \p cacheSize на треугольник.
+/// 3.0 — без повторного использования вообще, ~0.5 — предел для регулярных сеток.
+float acmr(const std::vector<std::uint32_t>& indices, std::size_t cacheSize = kVertexCacheSize);
+
+} // namespace render
@@ -5,35 +5,139 @@
 #ifndef RENDERER_HPP
 #define RENDERER_HPP
 
-#include "Utils/Scale.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <vector>
+#include "Utils/SfmlScale.hpp"
 #include <SFML/Graphics.hpp>
-#include "physics/Ball.hpp"
+#include "physics/BallStore.hpp"
+#include "physics/Pockets.hpp"
 
 namespace render {
 
+    /// Лёгкий 2D-режим «сверху» без OpenGL 3.3: стол, карманы и шары одним sf::VertexArray.
+    ///
+    /// Массив живёт между кадрами: вершины стола и карманов строятся один раз, цвета
+    /// шаров — при смене их числа, а каждый кадр переписываются только позиции шаров.
+    /// Вся сцена уходит одним win.draw. Координаты — как у ввода: метры × PPM = пиксели окна.
     class Renderer {
     public:
-        void drawBall(sf::RenderWindow& win, const physics::Ball& ball) {
-            // Получаем радиус шара в пикселях (хранится в m_radius в px)
-            float rPx = ball.radius();
-            sf::CircleShape shape(rPx);
+        Renderer()
+        {
+            // Единичная окружность на kSegments сторон — синусы один раз на весь рендер
+            for (int i = 0; i < kSegments; ++i) {
+                const float a = 2.f * 3.14159265f * float(i) / float(kSegments);
+                m_unit[i] = { std::cos(a), std::sin(a) };
+            }
+        }
+
+        /// Шары в текущих позициях (без интерполяции и без стола).
+        void drawBalls(sf::RenderWindow& w, const physics::BallStore& balls) {
+            m_sceneVerts = 0;
+            m_tableW     = -1.f;    // голову стола следующий drawScene построит заново
+            updateBalls(balls, balls, 1.f);
+            w.draw(m_verts);
+        }
+
+        /// Вся сцена: стол \p tableWpx × \p tableHpx, карманы и шары между шагами
+        /// \p prev → \p curr с долей \p alpha (как GLRenderer::drawScene).
+        void drawScene(sf::RenderWindow& w,
+                       const physics::BallStore& prev,
+                       const physics::BallStore& curr,
+                       float alpha,
+                       const std::vector<physics::Pocket>& pockets,
+                       float tableWpx, float tableHpx)
+        {
+            if (m_tableW != tableWpx || m_tableH != tableHpx || m_pocketCount != pockets.size())
+                buildScene(pockets, tableWpx, tableHpx);
+            updateBalls(prev, curr, std::clamp(alpha, 0.f, 1.f));
+            w.draw(m_verts);
+        }
+
+        /// Шаров в последнем кадре (все — за один вызов отрисовки).
+        [[nodiscard]] std::size_t lastBalls() const { return m_ballCount; }
 
-            // Центрируем форму по середине круга
-            shape.setOrigin({ rPx, rPx });
+    private:
+        static constexpr int   kSegments    = 24;               ///< сторон у круга шара/кармана
+        static constexpr int   kCircleVerts = kSegments * 3;    ///< веером из треугольников
+        static constexpr float kMaxLerpJumpM = 1.f;             ///< как в GLRenderer: телепорт не тянем
 
-            // Получаем позицию тела (в метрах) и конвертируем в пиксели
-            b2Vec2 posM = ball.body()->GetPosition();
-            sf::Vector2f posPx = m2px(sf::Vector2f{ posM.x, posM.y });
-            shape.setPosition(posPx);
+        /// Стол и карманы — неподвижная голова массива, шары пишутся после неё.
+        void buildScene(const std::vector<physics::Pocket>& pockets, float wPx, float hPx)
+        {
+            m_tableW = wPx;
+            m_tableH = hPx;
+            m_pocketCount = pockets.size();
+            m_sceneVerts  = 6 + pockets.size() * kCircleVerts;
+            m_ballCount   = 0;
+            m_verts.setPrimitiveType(sf::PrimitiveType::Triangles);
+            m_verts.resize(m_sceneVerts);
 
-            // Задаём цвет шара (можно расширить, чтобы шары разных цветов)
-            shape.setFillColor(sf::Color::White);
+            const sf::Color cloth(13, 90, 13);
+            const sf::Vector2f c[4] = { { 0.f, 0.f }, { wPx, 0.f }, { wPx, hPx }, { 0.f, hPx } };
+            const int quad[6] = { 0, 1, 2, 0, 2, 3 };
+            for (int i = 0; i < 6; ++i) {
+                m_verts[i].position = c[quad[i]];
+                m_verts[i].color    = cloth;
+            }
 
-            win.draw(shape);
+            std::size_t v = 6;
+            for (const physics::Pocket& p : pockets) {
+                writeCircle(v, m2px(toSf(p.center)), m2px(p.radius));
+                for (int k = 0; k < kCircleVerts; ++k) m_verts[v + k].color = sf::Color::Black;
+                v += kCircleVerts;
+            }
         }
-        void drawBalls(sf::RenderWindow& w, const std::vector<physics::Ball>& balls) {
-            for (auto& b : balls) drawBall(w, b);
+
+        void updateBalls(const physics::BallStore& prev, const physics::BallStore& curr, float alpha)
+        {
+            std::size_t alive = 0;
+            for (std::size_t i = 0; i < curr.size(); ++i) alive += curr.alive[i] ? 1 : 0;
+
+            // Размер меняется только когда шар упал в лузу — тогда же перекрашиваем
+            if (alive != m_ballCount || m_verts.getVertexCount() != m_sceneVerts + alive * kCircleVerts) {
+                m_ballCount = alive;
+                m_verts.setPrimitiveType(sf::PrimitiveType::Triangles);
+                m_verts.resize(m_sceneVerts + alive * kCircleVerts);
+                for (std::size_t v = m_sceneVerts; v < m_verts.getVertexCount(); ++v)
+                    m_verts[v].color = sf::Color::White;
+            }
+
+            std::size_t v = m_sceneVerts;
+            for (std::size_t i = 0; i < curr.size(); ++i) {
+                if (!curr.alive[i]) continue;
+                float x = curr.x[i], y = curr.y[i];
+                if (i < prev.size() && prev.alive[i]) {
+                    const float dx = x - prev.x[i], dy = y - prev.y[i];
+                    if (dx * dx + dy * dy < kMaxLerpJumpM * kMaxLerpJumpM) {
+                        x = prev.x[i] + dx * alpha;
+                        y = prev.y[i] + dy * alpha;
+                    }
+                }
+                writeCircle(v, m2px(sf::Vector2f{ x, y }), m2px(curr.r[i]));
+                v += kCircleVerts;
+            }
         }
+
+        /// Веер круга в m_verts[v .. v+kCircleVerts): только позиции, цвет не трогаем.
+        void writeCircle(std::size_t v, sf::Vector2f centerPx, float rPx)
+        {
+            for (int s = 0; s < kSegments; ++s) {
+                const sf::Vector2f a = m_unit[s];
+                const sf::Vector2f b = m_unit[(s + 1) % kSegments];
+                m_verts[v++].position = centerPx;
+                m_verts[v++].position = centerPx + a * rPx;
+                m_verts[v++].position = centerPx + b * rPx;
+            }
+        }
+
+        std::array<sf::Vector2f, kSegments> m_unit{};
+        sf::VertexArray m_verts{ sf::PrimitiveType::Triangles };
+        std::size_t     m_sceneVerts  = 0;     ///< вершин стола и карманов
+        std::size_t     m_pocketCount = 0;
+        std::size_t     m_ballCount   = 0;
+        float           m_tableW = -1.f, m_tableH = -1.f;
     };
 
 }
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <filesystem>
+#include <string>
+#include <unordered_map>
+#include <glm/glm.hpp>
+
+#include <glad/glad.h>
+
+namespace render {
+
+/// Шейдерная программа из пары файлов vert/frag.
+///
+/// После линковки программа сама опрашивает драйвер (glGetActiveUniform/Attrib) и
+/// держит таблицу «имя → location», так что в кадре нет ни одного glGetUniformLocation.
+/// Для каждого uniform'а запоминается последнее загруженное значение: повторная
+/// загрузка того же значения не доходит до драйвера.
+///
+/// reloadIfChanged() раз в kPollInterval смотрит время изменения исходников и
+/// пересобирает программу. Если новая версия не компилируется, остаётся старая —
+/// ошибка уходит в std::cerr, приложение продолжает работать.
+///
+/// Если задан setBinaryCacheDir(), слинкованная программа сохраняется на диск
+/// (glGetProgramBinary) и при следующем запуске поднимается без компиляции.
+/// Ключ — хэш исходников плюс GL_RENDERER/GL_VERSION; устаревшую или отвергнутую
+/// драйвером запись молча заменяем обычной сборкой.
+class ShaderProgram {
+public:
+    ShaderProgram() = default;
+    ~ShaderProgram();
+
+    ShaderProgram(const ShaderProgram&)            = delete;
+    ShaderProgram& operator=(const ShaderProgram&) = delete;
+
+    /// Читает, компилирует и линкует \p vertPath + \p fragPath. false при ошибке.
+    bool load(const std::string& vertPath, const std::string& fragPath);
+
+    /// Каталог кэша бинарников программ; пустая строка — кэш выключен. Вызывать до load().
+    void setBinaryCacheDir(std::string dir) { m_cacheDir = std::move(dir); }
+
+    /// Если исходники поменялись на диске — пересобирает. true, если программа сменилась.
+    bool reloadIfChanged();
+
+    void use() const { glUseProgram(m_id); }
+    [[nodiscard]] GLuint id() const { return m_id; }
+
+    /// location активного uniform'а / атрибута или -1 (нет такого или выкинут компилятором).
+    [[nodiscard]] int uniformLocation(const std::string& name) const;
+    [[nodiscard]] int attribLocation(const std::string& name) const;
+
+    // Загрузка uniform'ов (программа должна быть текущей, см. use()).
+    // Неактивные имена молча игнорируются, как и в самом OpenGL при location = -1.
+    void set(const std::string& name, float v);
+    void set(const std::string& name, int v);
+    void set(const std::string& name, const glm::vec3& v);
+    void set(const std::string& name, const glm::vec4& v);
+    void set(const std::string& name, const glm::mat4& m);
+
+    static constexpr std::chrono::milliseconds kPollInterval{500};
+
+private:
+    struct Uniform {
+        GLint                 location = -1;
+        GLenum                type     = 0;
+        GLint                 size     = 0;      ///< > 1 для массивов
+        std::array<float, 16> value{};           ///< последнее загруженное значение
+        bool                  cached   = false;
+    };
+
+    /// Значение uniform'а уже такое? Если нет — запоминает новое и возвращает указатель.
+    Uniform* changed(const std::string& name, const float* data, std::size_t count);
+
+    GLuint build(const std::string& vertCode, const std::string& fragCode, bool retrievable) const;
+
+    // Кэш бинарников (ARB_get_program_binary / GL 4.1)
+    std::filesystem::path cachePath(const std::string& vertCode, const std::string& fragCode) const;
+    GLuint loadBinary(const std::filesystem::path& path) const;
+    void   saveBinary(GLuint program, const std::filesystem::path& path) const;
+    void   reflect();
+
+    GLuint m_id = 0;
+    std::unordered_map<std::string, Uniform> m_uniforms;
+    std::unordered_map<std::string, GLint>   m_attribs;
+
+    std::string m_cacheDir;
+
+    // Горячая перезагрузка
+    std::string                               m_vertPath, m_fragPath;
+    std::filesystem::file_time_type           m_vertTime{}, m_fragTime{};
+    std::chrono::steady_clock::time_point     m_lastPoll{};
+};
+
+} // namespace render
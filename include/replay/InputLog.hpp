@@ -0,0 +1,117 @@
+#ifndef INPUTLOG_HPP
+#define INPUTLOG_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+#include <box2d/box2d.h>
+#include "sim/Simulation.hpp"
+
+// Реплей «только ввод» (.brpi): стол, расстановка и удары с номерами тиков —
+// остальное восстанавливает повторная симуляция. Партия — сотни байт вместо
+// килобайт .brpl, но смотреть её можно только пересчитав (replayInputs).
+//
+//   InputHeader
+//   запись*  — байт-тег, varint dtick (от тика предыдущей записи), тело
+//   kInputEnd
+//
+// Удар kInputShot с тиком t применяется перед (t+1)-м вызовом Simulation::tick —
+// так же, как SimThread::applyShots. Контрольные точки kInputCheck — младшие
+// 32 бита World::stateHash() после тика t: пишутся, пока стол движется, раз в
+// checkpointTicks тиков и в тик остановки. Повтор, разошедшийся с записью,
+// ловится на первой же контрольной точке после расхождения; с checkpointTicks = 1
+// — ровно на том тике, где оно случилось (режим регрессионной сверки физики).
+
+namespace replay {
+
+    constexpr char          kInputMagic[4]   = { 'B', 'R', 'P', 'I' };
+    constexpr std::uint16_t kInputVersion    = 1;
+    constexpr std::uint32_t kCheckpointTicks = 60;   ///< 1 с при 60 Гц
+
+    struct InputHeader {
+        char          magic[4];
+        std::uint16_t version;
+        std::uint8_t  backend;          ///< physics::Backend
+        std::uint8_t  flags;            ///< пока 0
+        float         step;             ///< длина тика, с
+        std::uint32_t checkpointTicks;
+        float         table[10];        ///< sim::TableConfig по полям, в порядке объявления
+        std::uint64_t rackHash;         ///< World::stateHash() сразу после расстановки
+    };
+
+    enum InputTag : std::uint8_t {
+        kInputEnd   = 0x00,   ///< varint dtick до последнего тика, u64 stateHash() на нём
+        kInputShot  = 0x01,   ///< varint slot, f32 ix, f32 iy — импульс, Н·с, побитово
+        kInputCheck = 0x02,   ///< u32 — младшие биты stateHash()
+    };
+
+    struct InputShot {
+        std::uint64_t tick;
+        int           slot;
+        b2Vec2        impulse;
+    };
+
+    struct InputCheckpoint {
+        std::uint64_t tick;
+        std::uint32_t hash;
+    };
+
+    /// Содержимое .brpi целиком: файл маленький и читается за раз.
+    struct InputLog {
+        sim::TableConfig             cfg;
+        physics::Backend             backend         = physics::Backend::Box2D;
+        float                        step            = 1.f / 60.f;
+        std::uint32_t                checkpointTicks = kCheckpointTicks;
+        std::uint64_t                rackHash        = 0;
+        std::vector<InputShot>       shots;          ///< по возрастанию тика
+        std::vector<InputCheckpoint> checkpoints;    ///< по возрастанию тика
+        std::uint64_t                ticks           = 0;   ///< номер последнего тика
+        std::uint64_t                finalHash       = 0;
+
+        /// Записать в \p path; возвращает размер файла в байтах или 0 при ошибке.
+        std::size_t save(const std::string& path) const;
+        /// false — не файл .brpi, чужая версия или запись оборвана.
+        bool load(const std::string& path);
+    };
+
+    /// Сбор InputLog по ходу игры. Зовётся из того же потока, что крутит
+    /// Simulation (SimThread или цикл billiards_sim); на тик — сравнение хеша.
+    class InputRecorder {
+    public:
+        /// Начать запись со стола \p table в его текущем состоянии (обычно — сразу
+        /// после конструктора). \p step — длина тика, с.
+        void begin(const sim::Simulation& table, float step, std::uint32_t checkpointTicks = kCheckpointTicks);
+
+        /// Удар по слоту \p slot, применённый перед тиком \p tick + 1.
+        void shot(std::uint64_t tick, int slot, const b2Vec2& impulse);
+        /// Сделан тик номер \p tick.
+        void tick(std::uint64_t tick, const sim::Simulation& table);
+
+        [[nodiscard]] const InputLog& log() const { return m_log; }
+
+    private:
+        InputLog      m_log;
+        std::uint64_t m_checkHash = 0;   // хеш последней контрольной точки
+        std::uint64_t m_checkTick = 0;
+    };
+
+    /// Итог повторной симуляции.
+    struct InputVerdict {
+        bool          ok        = false;
+        std::uint64_t ticks     = 0;   ///< докуда дошёл повтор
+        std::uint64_t lastGood  = 0;   ///< последний тик, где хеш совпал
+        std::uint64_t diverged  = 0;   ///< первый несовпавший тик (при !ok); 0 — не та расстановка
+        std::size_t   checked   = 0;   ///< сверено контрольных точек
+    };
+
+    /// Переиграть \p log на столе \p table, собранном из log.cfg / log.backend и ещё
+    /// не тронутом. Останавливается на первом расхождении. \p onTick (если задан)
+    /// зовётся после каждого тика — например, чтобы писать .brpl для просмотра;
+    /// без него простои стола между ударами проматываются без вызовов tick().
+    InputVerdict replayInputs(const InputLog& log, sim::Simulation& table,
+                              const std::function<void(std::uint64_t, const sim::Simulation&)>& onTick = {});
+
+} // namespace replay
+
+#endif //INPUTLOG_HPP
@@ -0,0 +1,141 @@
+#ifndef REPLAYFORMAT_HPP
+#define REPLAYFORMAT_HPP
+
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// Формат файла реплея (.brpl), общий для ReplayWriter и чтения.
+//
+//   FileHeader
+//   запись*            — байт-тег + тело, числа — varint (LEB128), разности — zigzag
+//   kEnd, varint ticks — конец записи; без него файл обрезан (падение, переполнение)
+//   IndexEntry × count — ключевые кадры по возрастанию тика (оглавление для перемотки)
+//   IndexTrailer       — хвост файла: где оглавление, сколько в нём записей, всего тиков
+//
+// Позиции квантуются до 1/kUnitsPerMeter м (0.24 мм = 0.02 px при PPM 100).
+// У каждого шара есть позиция q и «скорость» d — сдвиг q за тик; обе хранятся
+// с kFracBits дробными битами. Читатель и писатель одинаково предсказывают
+// следующий тик по затуханию шара:
+//     d = decay(d); q += d        (decay — целочисленно, header.decayQ16)
+// Пока предсказание отстаёт от настоящей позиции не больше header.tolerance
+// единиц, писать нечего. Иначе в kDelta уходит поправка (ex, ey, vx, vy):
+//     q = (round(q) + e) << kFracBits; d += v
+// — после неё q совпадает с настоящей позицией, d — с настоящей скоростью шара.
+// Писатель ведёт ту же модель, что и читатель, поэтому ошибка не копится:
+// round(q) отличается от игры не больше чем на tolerance, сама q с дробью —
+// на tolerance + 1 единицу (0.7 мм ≈ 0.07 px).
+// Затухающий шар стоит одну поправку на соударение и одну на остановку.
+// Тики без поправок копятся в одну kIdle, стоящий стол — пара байт на всю паузу.
+// Раз в kKeyframeTicks тиков (если стол двигался) пишется kKeyframe — точное
+// состояние, с которого можно начать декодирование.
+
+namespace replay {
+
+    constexpr char          kMagic[4]       = { 'B', 'R', 'P', 'L' };
+    constexpr std::uint16_t kVersion        = 1;
+    constexpr float         kUnitsPerMeter  = 4096.f;
+    constexpr std::uint32_t kKeyframeTicks  = 600;      ///< 10 с при 60 Гц
+    constexpr std::int32_t  kTolerance      = 2;        ///< допуск предсказания, единиц
+    constexpr int           kFracBits       = 8;        ///< дробных бит у q и d
+
+    struct FileHeader {
+        char          magic[4];
+        std::uint16_t version;
+        std::uint16_t flags;        ///< пока 0
+        float         step;         ///< длина тика, с
+        float         unitsPerMeter;
+        std::int32_t  decayQ16;     ///< затухание d за тик, 1.0 = 65536
+        std::int32_t  tolerance;    ///< допуск предсказания, единиц
+    };
+
+    constexpr char kIndexMagic[4] = { 'B', 'R', 'P', 'X' };
+
+    struct IndexEntry {
+        std::uint64_t tick;
+        std::uint64_t offset;       ///< от начала файла, на байт-тег kKeyframe
+    };
+
+    struct IndexTrailer {
+        std::uint64_t indexOffset;
+        std::uint64_t ticks;        ///< как в kEnd
+        std::uint32_t count;
+        char          magic[4];     ///< kIndexMagic; нет — файл обрезан, оглавление строит чтение
+    };
+
+    enum Tag : std::uint8_t {
+        kEnd      = 0x00,   ///< varint: всего тиков
+        kDelta    = 0x01,   ///< +1 тик. Маска слотов (ceil(slots/8) байт, бит i — слот i), по слоту из маски zz ex, ey (единицы), zz vx, vy (с дробью)
+        kIdle     = 0x02,   ///< varint n: n тиков без поправок (только предсказание)
+        kScore    = 0x03,   ///< varint: новый счёт
+        kAlive    = 0x04,   ///< varint slot: шар выпал/вернулся; вернувшийся — ещё zz qx, zz qy (единицы), zz dx, zz dy (с дробью)
+        kKeyframe = 0x05,   ///< varint tick, varint score, varint slots; slots × { u8 alive, varint qr, zz qx, zz qy (единицы), zz dx, zz dy (с дробью) }
+    };
+    // kScore и kAlive тик не сдвигают и относятся к ближайшему следующему тику.
+
+    /// Затухание за тик в Q16 для демпфирования \p damping (1/с) и тика \p step (с).
+    [[nodiscard]] inline std::int32_t decayQ16(float damping, float step)
+    {
+        return static_cast<std::int32_t>(std::lround(65536.0 * std::exp(-double(damping) * step)));
+    }
+
+    /// Предсказанный d следующего тика (с дробью), округление к ближайшему.
+    [[nodiscard]] inline std::int32_t decay(std::int32_t d, std::int32_t q16)
+    {
+        return static_cast<std::int32_t>((std::int64_t(d) * q16 + 32768) >> 16);
+    }
+
+    /// q с дробью → целые единицы, к ближайшему.
+    [[nodiscard]] inline std::int32_t roundFrac(std::int32_t q)
+    {
+        return (q + (1 << (kFracBits - 1))) >> kFracBits;
+    }
+
+    [[nodiscard]] inline std::int32_t quantize(float m)
+    {
+        return static_cast<std::int32_t>(std::lround(m * kUnitsPerMeter));
+    }
+
+    [[nodiscard]] inline float dequantize(std::int32_t q)
+    {
+        return static_cast<float>(q) / kUnitsPerMeter;
+    }
+
+    inline void putVarint(std::vector<std::uint8_t>& out, std::uint64_t v)
+    {
+        while (v >= 0x80) {
+            out.push_back(static_cast<std::uint8_t>(v | 0x80));
+            v >>= 7;
+        }
+        out.push_back(static_cast<std::uint8_t>(v));
+    }
+
+    /// Знаковая разность → беззнаковое: маленькие по модулю числа — короткий varint.
+    inline void putZigzag(std::vector<std::uint8_t>& out, std::int32_t v)
+    {
+        putVarint(out, (static_cast<std::uint32_t>(v) << 1) ^ static_cast<std::uint32_t>(v >> 31));
+    }
+
+    /// Разбор varint из [p, end). false — данные кончились посреди числа.
+    inline bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::uint64_t& v)
+    {
+        v = 0;
+        for (int shift = 0; p < end && shift < 64; shift += 7) {
+            const std::uint8_t b = *p++;
+            v |= std::uint64_t(b & 0x7F) << shift;
+            if (!(b & 0x80)) return true;
+        }
+        return false;
+    }
+
+    inline bool getZigzag(const std::uint8_t*& p, const std::uint8_t* end, std::int32_t& v)
+    {
+        std::uint64_t u;
+        if (!getVarint(p, end, u)) return false;
+        v = static_cast<std::int32_t>(static_cast<std::uint32_t>(u >> 1) ^ (0u - static_cast<std::uint32_t>(u & 1)));
+        return true;
+    }
+
+} // namespace replay
+
+#endif //REPLAYFORMAT_HPP
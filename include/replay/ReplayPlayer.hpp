@@ -0,0 +1,79 @@
+#ifndef REPLAYPLAYER_HPP
+#define REPLAYPLAYER_HPP
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include "physics/BallStore.hpp"
+#include "replay/ReplayReader.hpp"
+
+namespace replay {
+
+    /// Проигрывание реплея в реальном времени поверх ReplayReader.
+    ///
+    /// Часы проигрывателя идут от update(); кадр рисует lerp(prev(), curr(), alpha())
+    /// тем же GLRenderer::drawScene, что и живую игру (см. SimThread::alpha).
+    /// Перемотка — ReplayReader::seek, то есть ключ по оглавлению плюс короткая докрутка.
+    class ReplayPlayer {
+    public:
+        bool open(const std::string& path)
+        {
+            if (!m_reader.open(path)) return false;
+            m_time = 0.0;
+            m_prev = m_reader.balls();
+            return true;
+        }
+
+        /// Сдвинуть часы на \p dt секунд реального времени (на паузе — ничего).
+        void update(float dt)
+        {
+            if (m_paused || !m_reader.isOpen()) return;
+            const double end = double(m_reader.ticks() - 1) * m_reader.step();
+            m_time = std::min(m_time + dt, end);
+
+            const auto target = static_cast<std::uint64_t>(m_time / m_reader.step());
+            if (target <= m_reader.tick()) return;
+            // Пропущенные тики декодируются подряд; prev — только перед последним
+            while (m_reader.tick() + 1 < target && m_reader.next()) {}
+            m_prev = m_reader.balls();
+            m_reader.next();
+        }
+
+        /// Перейти на \p seconds от начала записи.
+        void seek(double seconds)
+        {
+            if (!m_reader.isOpen()) return;
+            const double end = double(m_reader.ticks() - 1) * m_reader.step();
+            m_time = std::clamp(seconds, 0.0, end);
+            m_reader.seek(static_cast<std::uint64_t>(m_time / m_reader.step()));
+            m_prev = m_reader.balls();   // после прыжка интерполировать не с чем
+        }
+
+        void togglePause() { m_paused = !m_paused; }
+
+        [[nodiscard]] double                    time()   const { return m_time; }
+        [[nodiscard]] bool                      paused() const { return m_paused; }
+        [[nodiscard]] const physics::BallStore& prev()   const { return m_prev; }
+        [[nodiscard]] const physics::BallStore& curr()   const { return m_reader.balls(); }
+        [[nodiscard]] int                       score()  const { return m_reader.score(); }
+        [[nodiscard]] const ReplayReader&       reader() const { return m_reader; }
+
+        /// Доля шага между prev() и curr(), в [0, 1].
+        [[nodiscard]] float alpha() const
+        {
+            if (!m_reader.isOpen()) return 1.f;
+            const double ticks = m_time / m_reader.step();
+            return static_cast<float>(std::clamp(ticks - std::floor(ticks), 0.0, 1.0));
+        }
+
+    private:
+        ReplayReader       m_reader;
+        physics::BallStore m_prev;
+        double             m_time   = 0.0;   // с от начала записи
+        bool               m_paused = false;
+    };
+
+} // namespace replay
+
+#endif //REPLAYPLAYER_HPP
@@ -0,0 +1,80 @@
+#ifndef REPLAYREADER_HPP
+#define REPLAYREADER_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "physics/BallStore.hpp"
+#include "replay/ReplayFormat.hpp"
+
+namespace replay {
+
+    /// Чтение реплея (формат — ReplayFormat.hpp) прямо из отображённого в память файла.
+    ///
+    /// Файл не читается целиком: open() отображает его (mmap / MapViewOfFile) и
+    /// копирует только оглавление ключевых кадров из хвоста — по записи на 10 с игры.
+    /// seek() находит ближайший ключ не позже нужного тика двоичным поиском и
+    /// докручивает от него не больше kKeyframeTicks тиков; страницы файла подгружает
+    /// ОС, и только те, что реально прочитаны. У обрезанного файла (нет хвоста)
+    /// оглавление строится одним проходом при open().
+    class ReplayReader {
+    public:
+        ReplayReader() = default;
+        ~ReplayReader();
+
+        ReplayReader(const ReplayReader&)            = delete;
+        ReplayReader& operator=(const ReplayReader&) = delete;
+
+        /// Открыть и встать на первый тик. false — не файл реплея или он пуст.
+        bool open(const std::string& path);
+        void close();
+
+        [[nodiscard]] bool          isOpen()    const { return m_data != nullptr; }
+        [[nodiscard]] float         step()      const { return m_header.step; }
+        /// Тиков в записи: номер последнего + 1.
+        [[nodiscard]] std::uint64_t ticks()     const { return m_ticks; }
+        [[nodiscard]] bool          truncated() const { return m_truncated; }
+        [[nodiscard]] std::size_t   keyframes() const { return m_index.size(); }
+
+        /// Встать на тик \p tick (за пределами записи — на ближайший край).
+        bool seek(std::uint64_t tick);
+        /// Следующий тик. false — запись кончилась.
+        bool next();
+
+        [[nodiscard]] std::uint64_t             tick()  const { return m_tick; }
+        [[nodiscard]] int                       score() const { return m_score; }
+        /// Шары на текущем тике: x, y, r, alive; vx, vy — восстановленные скорости.
+        [[nodiscard]] const physics::BallStore& balls() const { return m_balls; }
+
+    private:
+        bool map(const std::string& path);
+        void unmap();
+        bool buildIndex();
+        bool readKeyframe();
+        bool advance();          // один тик вперёд, разбирая записи
+        void predict();
+        void publish();          // q, d → m_balls
+
+        // Отображение файла
+        const std::uint8_t* m_data = nullptr;
+        std::size_t         m_size = 0;
+
+        FileHeader              m_header{};
+        std::vector<IndexEntry> m_index;
+        std::uint64_t           m_ticks     = 0;
+        bool                    m_truncated = false;
+
+        // Курсор декодера
+        const std::uint8_t*       m_p   = nullptr;
+        const std::uint8_t*       m_end = nullptr;   // конец записей (начало оглавления)
+        std::uint64_t             m_tick     = 0;
+        std::uint64_t             m_idleLeft = 0;    // ещё тиков в текущей kIdle
+        int                       m_score    = 0;
+        std::vector<std::int32_t> m_qx, m_qy, m_dx, m_dy;
+        std::vector<std::uint8_t> m_alive;
+        physics::BallStore        m_balls;
+    };
+
+} // namespace replay
+
+#endif //REPLAYREADER_HPP
@@ -0,0 +1,95 @@
+#ifndef REPLAYWRITER_HPP
+#define REPLAYWRITER_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "physics/BallStore.hpp"
+#include "replay/ReplayFormat.hpp"
+
+namespace replay {
+
+    /// Потоковая запись реплея (формат — ReplayFormat.hpp).
+    ///
+    /// record() зовёт поток физики после каждого тика: кодирование в память —
+    /// проход по ~16 шарам и несколько байт varint. Готовые блоки по kBlockBytes
+    /// уходят фоновому потоку, который пишет их на диск; очередь ограничена
+    /// kMaxQueuedBlocks. Если диск не успевает и очередь полна, запись прекращается
+    /// (failed()) — файл обрывается на последнем целом блоке, но поток физики не ждёт.
+    class ReplayWriter {
+    public:
+        static constexpr std::size_t kBlockBytes      = 16 * 1024;
+        static constexpr std::size_t kMaxQueuedBlocks = 64;     ///< 1 МБ в полёте
+        static constexpr std::uint32_t kFlushTicks    = 300;    ///< неполный блок — не дольше 5 с
+
+        ReplayWriter() = default;
+        ~ReplayWriter();
+
+        ReplayWriter(const ReplayWriter&)            = delete;
+        ReplayWriter& operator=(const ReplayWriter&) = delete;
+
+        /// Создать файл \p path и запустить поток записи. \p step — длина тика, с;
+        /// \p damping — линейное демпфирование шаров, 1/с (physics::kBallLinearDamping):
+        /// по нему предсказываются тики.
+        bool open(const std::string& path, float step, float damping);
+
+        /// Состояние после тика \p tick. Тики идут подряд; после пропуска пишется ключевой кадр.
+        void record(std::uint64_t tick, const physics::BallStore& balls, int score);
+
+        /// Дописать kEnd и оглавление ключевых кадров, дождаться диска и закрыть файл.
+        void close();
+
+        [[nodiscard]] bool          isOpen()  const { return m_thread.joinable(); }
+        /// Очередь переполнилась или диск вернул ошибку — дальше тики не пишутся.
+        [[nodiscard]] bool          failed()  const { return m_failed.load(std::memory_order_relaxed); }
+        /// Байт закодировано (включая ещё не записанные).
+        [[nodiscard]] std::uint64_t bytes()   const { return m_bytes; }
+
+    private:
+        void writeKeyframe(std::uint64_t tick, const physics::BallStore& balls, int score);
+        [[nodiscard]] std::int32_t velocity(float v) const;
+        void flushIdle();
+        void handOff();
+        void run();
+
+        // Поток физики
+        std::vector<std::uint8_t>  m_block;
+        std::vector<std::int32_t>  m_qx, m_qy;      // состояние, как его восстановит читатель (с дробью)
+        std::vector<std::int32_t>  m_dx, m_dy;
+        std::vector<std::uint8_t>  m_alive;
+        std::vector<std::uint8_t>  m_mask;          // черновики kDelta, без аллокаций по тикам
+        std::vector<std::int32_t>  m_residuals;
+        std::vector<IndexEntry>    m_index;         // ключевые кадры — в хвост файла при close()
+        std::uint64_t              m_nextTick   = 0;
+        std::uint64_t              m_keyTick    = 0;
+        std::uint64_t              m_handOffTick = 0;
+        std::uint64_t              m_idle       = 0;   // тиков без изменений подряд
+        std::uint64_t              m_bytes      = 0;
+        std::int32_t               m_decay      = 65536;
+        float                      m_step       = 0.f;
+        float                      m_stepUnits  = 0.f;   // м/с → сдвиг за тик в единицах с дробью
+        int                        m_score      = 0;
+        bool                       m_started    = false;
+        bool                       m_dirty      = false;   // менялось ли что-то с прошлого ключа
+        std::atomic<bool>          m_failed{ false };  // ставят оба потока
+
+        // Общее с потоком записи
+        std::mutex                              m_mutex;
+        std::condition_variable                 m_cv;
+        std::deque<std::vector<std::uint8_t>>   m_queue;
+        std::vector<std::vector<std::uint8_t>>  m_spare;    // пустые блоки обратно, без аллокаций
+        bool                                    m_closing = false;
+
+        std::ofstream m_file;
+        std::thread   m_thread;
+    };
+
+} // namespace replay
+
+#endif //REPLAYWRITER_HPP
@@ -0,0 +1,48 @@
+#ifndef FIXEDSTEPCLOCK_HPP
+#define FIXEDSTEPCLOCK_HPP
+
+#include <algorithm>
+
+namespace sim {
+
+    /// Часы симуляции с фиксированным шагом (аккумулятор времени).
+    ///
+    /// Кадр рендера может длиться сколько угодно; прошедшее реальное время копится,
+    /// и физика делает столько шагов ровно по step() секунд, сколько в него поместилось.
+    /// Остаток переносится в следующий кадр, так что время симуляции не уплывает от
+    /// реального. Если кадр затянулся (перетаскивание окна, отладчик), шагов за кадр
+    /// не больше maxStepsPerFrame — лишнее время выбрасывается, стол просто «замедляется»
+    /// вместо того, чтобы догонять всё более долгими кадрами.
+    class FixedStepClock {
+    public:
+        explicit FixedStepClock(float step, int maxStepsPerFrame = 8)
+            : m_step(step), m_maxSteps(maxStepsPerFrame) {}
+
+        /// Добавляет \p frameSeconds реального времени, возвращает число шагов к выполнению.
+        int advance(float frameSeconds)
+        {
+            m_acc += std::max(frameSeconds, 0.f);
+            int steps = static_cast<int>(m_acc / m_step);
+            if (steps > m_maxSteps) {
+                steps = m_maxSteps;
+                m_acc = 0.f;
+            } else {
+                m_acc -= steps * m_step;
+            }
+            return steps;
+        }
+
+        [[nodiscard]] float step() const { return m_step; }
+
+        /// Доля шага, накопленная сверх выполненных шагов, в [0, 1).
+        [[nodiscard]] float alpha() const { return m_acc / m_step; }
+
+    private:
+        float m_step;
+        int   m_maxSteps;
+        float m_acc = 0.f;
+    };
+
+} // namespace sim
+
+#endif //FIXEDSTEPCLOCK_HPP
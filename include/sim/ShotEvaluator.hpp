@@ -0,0 +1,91 @@
+#ifndef SHOTEVALUATOR_HPP
+#define SHOTEVALUATOR_HPP
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <box2d/box2d.h>
+#include "sim/Simulation.hpp"
+
+namespace sim {
+
+    /// Итог одного варианта удара.
+    struct ShotOutcome {
+        std::vector<int>       potted;        ///< слоты забитых шаров в порядке попадания (биток — тоже)
+        bool                   cuePotted = false;
+        physics::WorldSnapshot final;         ///< позиции и флаги alive всех слотов после остановки
+        long                   ticks     = 0; ///< сколько кадров Simulation::tick до остановки
+    };
+
+    /// Параллельный перебор вариантов удара из одной позиции.
+    ///
+    /// Пул из N потоков, у каждого — собственная Simulation с той же конфигурацией стола
+    /// (b2World копировать нельзя, поэтому «клон» — это отдельный стол + restore()).
+    /// Кандидаты раздаются через общий атомарный счётчик: поток берёт следующий номер,
+    /// строит стол заново, восстанавливает стартовый снимок, бьёт и крутит кадры до
+    /// остановки. Свежий стол на каждого кандидата — не лишний: restore() не трогает
+    /// контакты Box2D и дерево broad-phase, и без пересборки итог зависел бы от того,
+    /// какие кандидаты этот поток считал раньше. Так ShotOutcome совпадает бит в бит
+    /// при любом числе потоков и любом порядке раздачи. Потоки переживают вызовы evaluate().
+    ///
+    /// Стартовый снимок должен быть снят со стола с той же TableConfig: раскладка слотов
+    /// у всех Simulation одинакова, пока шары только забиваются (World::pot), а не удаляются.
+    class ShotEvaluator {
+    public:
+        /// \param threads — число рабочих потоков; 0 — std::thread::hardware_concurrency()
+        explicit ShotEvaluator(const TableConfig& cfg = {},
+                               physics::Backend backend = physics::Backend::Box2D,
+                               unsigned threads = 0,
+                               float dt = 1.0f / 120.0f);
+        ~ShotEvaluator();
+
+        ShotEvaluator(const ShotEvaluator&)            = delete;
+        ShotEvaluator& operator=(const ShotEvaluator&) = delete;
+
+        /// Просчитывает каждый импульс из \p impulses (Н·с, как sim::shotImpulse) от позиции
+        /// \p start до остановки шаров. out[i] соответствует impulses[i]; буферы внутри out
+        /// переиспользуются между вызовами. Блокирует до завершения всех кандидатов.
+        void evaluate(const Snapshot& start, const std::vector<b2Vec2>& impulses,
+                      std::vector<ShotOutcome>& out);
+
+        [[nodiscard]] std::vector<ShotOutcome> evaluate(const Snapshot& start,
+                                                        const std::vector<b2Vec2>& impulses);
+
+        [[nodiscard]] unsigned threads() const { return static_cast<unsigned>(m_workers.size()); }
+
+    private:
+        struct Worker {
+            std::unique_ptr<Simulation> table;   // стол текущего кандидата
+            std::thread                 thread;
+        };
+
+        void workerLoop(Worker& worker);
+        void run(Worker& worker, const b2Vec2& impulse, ShotOutcome& out) const;
+
+        TableConfig              m_cfg;
+        physics::Backend         m_backend;
+        float                    m_dt;
+        long                     m_maxTicks;     // страховка от бесконечного удара
+        std::vector<Worker>      m_workers;
+
+        // Текущее задание; меняется только под m_mutex, пока все потоки спят
+        const Snapshot*             m_start    = nullptr;
+        const std::vector<b2Vec2>*  m_impulses = nullptr;
+        std::vector<ShotOutcome>*   m_out      = nullptr;
+        std::atomic<std::size_t>    m_next{0};
+
+        std::mutex               m_mutex;
+        std::condition_variable  m_wake;         // новое задание или остановка
+        std::condition_variable  m_done;         // все потоки закончили задание
+        unsigned                 m_generation = 0;
+        unsigned                 m_busy       = 0;
+        bool                     m_stop       = false;
+    };
+
+} // namespace sim
+
+#endif //SHOTEVALUATOR_HPP
@@ -0,0 +1,99 @@
+#ifndef SIMTHREAD_HPP
+#define SIMTHREAD_HPP
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <box2d/box2d.h>
+#include "physics/BallStore.hpp"
+#include "physics/SlotMap.hpp"
+#include "replay/InputLog.hpp"
+#include "replay/ReplayWriter.hpp"
+#include "sim/Simulation.hpp"
+#include "sim/TripleBuffer.hpp"
+
+namespace sim {
+
+    /// Удар, заказанный потоком ввода: шар по handle (слот мог смениться) и импульс, Н·с.
+    struct Shot {
+        physics::SlotHandle ball;
+        b2Vec2              impulse{ 0.f, 0.f };
+    };
+
+    /// Неизменяемый снимок стола для рендера и ввода — всё, что им нужно, без World.
+    struct FrameState {
+        physics::BallStore               balls;      ///< как World::balls() после шага
+        physics::BallStore               prev;       ///< то же шагом раньше — для интерполяции
+        std::vector<physics::SlotHandle> handles;    ///< handle каждого слота balls
+        int                              score  = 0;
+        bool                             atRest = true;
+        std::uint64_t                    tick   = 0; ///< номер шага симуляции
+        /// Реальное время, которому соответствует balls (граница шага на часах потока).
+        std::chrono::steady_clock::time_point stepTime{};
+    };
+
+    /// Физика в отдельном потоке.
+    ///
+    /// Поток крутит Simulation::tick() с фиксированным шагом по своим часам
+    /// (FixedStepClock) и после каждой пачки шагов публикует FrameState через
+    /// TripleBuffer. Рендер берёт последний снимок через latest() и не ждёт физику;
+    /// долгий кадр не замедляет время симуляции, тяжёлый разбой не съедает кадры.
+    ///
+    /// Пока поток запущен, Simulation трогает только он. Неизменяемые после
+    /// конструктора config() и pockets() читать из других потоков можно.
+    class SimThread {
+    public:
+        SimThread(Simulation& table, float step);
+        ~SimThread();
+
+        SimThread(const SimThread&)            = delete;
+        SimThread& operator=(const SimThread&) = delete;
+
+        void start();
+        void stop();
+
+        /// Писать каждый тик в реплей (nullptr — не писать). Только до start().
+        void setRecorder(replay::ReplayWriter* recorder) { m_recorder = recorder; }
+        /// Писать удары и контрольные хеши (replay::InputLog). Только до start();
+        /// begin() на нём вызывает владелец, читать log() — после stop().
+        void setInputRecorder(replay::InputRecorder* inputs) { m_inputs = inputs; }
+
+        /// Поставить удар в очередь; применится перед следующим шагом.
+        void post(const Shot& shot);
+
+        /// Последний опубликованный снимок (только из одного потока-читателя).
+        /// Ссылка действительна до следующего вызова latest().
+        const FrameState& latest();
+
+        /// Доля шага, прошедшая с момента \p s.stepTime к \p now, в [0, 1]: рендер рисует
+        /// lerp(s.prev, s.balls, alpha) и отстаёт от физики ровно на один шаг.
+        [[nodiscard]] float alpha(const FrameState& s,
+                                  std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now()) const;
+
+        [[nodiscard]] float step() const { return m_step; }
+
+    private:
+        void run();
+        void applyShots();
+        void publish(std::chrono::steady_clock::time_point stepTime);
+
+        Simulation&              m_table;
+        float                    m_step;
+        TripleBuffer<FrameState> m_states;
+        std::uint64_t            m_tick = 0;
+        replay::ReplayWriter*    m_recorder = nullptr;
+        replay::InputRecorder*   m_inputs   = nullptr;
+
+        std::mutex               m_shotMutex;      // удары редкие — хватает мьютекса
+        std::vector<Shot>        m_shots, m_pending;
+
+        std::atomic<bool>        m_stop{ false };
+        std::thread              m_thread;
+    };
+
+} // namespace sim
+
+#endif //SIMTHREAD_HPP
@@ -0,0 +1,118 @@
+#ifndef SIMULATION_HPP
+#define SIMULATION_HPP
+
+#include <cstdint>
+#include <vector>
+#include <box2d/box2d.h>
+#include "physics/World.hpp"
+#include "physics/Table.hpp"
+#include "physics/Ball.hpp"
+#include "physics/Pockets.hpp"
+#include "physics/SlotMap.hpp"
+#include "Utils/Scale.hpp"
+
+namespace sim {
+
+    /// Геометрия стола и стартовая расстановка (все размеры в пикселях, 100 px = 1 m).
+    struct TableConfig {
+        float widthPx        = 1280.f;
+        float heightPx       = 720.f;
+        float cushionPx      = 20.f;    ///< отступ от края до борта
+        float ballRadiusPx   = 10.f;
+        float pocketRadiusPx = 18.f;
+        float rackGapPx      = 0.5f;    ///< зазор между шарами пирамиды
+        Vec2f cueStartPx     { 300.f, 360.f };
+        Vec2f rackApexPx     { 900.f, 360.f };
+    };
+
+    /// Импульс удара по вектору оттяжки \p dragM (метры): направление — вдоль оттяжки,
+    /// величина линейно растёт до \p maxImpulse при длине \p maxDrag.
+    b2Vec2 shotImpulse(const Vec2f& dragM, float maxDrag, float maxImpulse);
+
+    /// Снимок Simulation: состояние мира плюс счёт (см. physics::World::snapshot).
+    struct Snapshot {
+        physics::WorldSnapshot world;
+        int                    score = 0;
+    };
+
+    /// Стол целиком: мир Box2D, борта, биток + пирамида из 15 шаров, карманы.
+    /// Не зависит от SFML/OpenGL — тот же цикл крутят и окно (main.cpp), и billiards_sim.
+    class Simulation {
+    public:
+        explicit Simulation(const TableConfig& cfg = {},
+                            physics::Backend backend = physics::Backend::Box2D);
+
+        Simulation(const Simulation&)            = delete;
+        Simulation& operator=(const Simulation&) = delete;
+
+        /// Один шаг симуляции длиной \p dt: подшаги физики, гашение медленных скоростей,
+        /// проверка карманов. Число подшагов выбирается по самому быстрому шару так, чтобы
+        /// за подшаг он проходил не больше kMaxTravelPerSubstep своего радиуса
+        /// (стоящий стол — один подшаг, сильный разбой — до kMaxSubsteps).
+        /// Событийному решателю подшаги не нужны — у него всегда один.
+        /// Если все шары спят (World::idle), tick() сразу возвращает 0.
+        /// Иначе в конце подмешивает состояние в World::stateHash() — тики покоя
+        /// хеш не меняют, стол в них тоже не меняется.
+        /// Возвращает число забитых за шаг прицельных шаров (биток возвращается на место).
+        int tick(float dt);
+
+        /// Сколько подшагов взял бы tick(\p dt) при текущих скоростях.
+        [[nodiscard]] int substepsFor(float dt) const;
+        /// Сколько подшагов сделал последний tick() (0 — стол был в покое).
+        [[nodiscard]] int lastSubsteps() const { return m_lastSubsteps; }
+
+        static constexpr float kMaxTravelPerSubstep = 0.25f;   ///< доля радиуса шара
+        static constexpr int   kMaxSubsteps         = 16;
+
+        /// Удар по битку импульсом \p impulse (Н·с). false, если биток не найден.
+        bool shoot(const b2Vec2& impulse);
+
+        /// Все шары стоят (скорости ниже kRestLinearSpeed / kRestAngularSpeed).
+        [[nodiscard]] bool atRest() const;
+
+        /// Сохранить/восстановить позицию, например чтобы перебрать варианты удара.
+        void snapshot(Snapshot& out) const;
+        void restore(const Snapshot& snap);
+
+        /// Сколько шаров (включая биток) ещё на столе.
+        [[nodiscard]] int ballsLeft() const;
+
+        /// Слоты шаров, попавших в карман за последний tick(), в порядке попадания.
+        /// Биток тоже попадает в список, хотя к этому моменту уже вернулся на место.
+        [[nodiscard]] const std::vector<int>& pottedLastTick() const { return m_lastPotted; }
+
+        /// Слот битка в World::balls() или -1, если битка нет.
+        [[nodiscard]] int cueSlot() const;
+
+        /// Вернуть стартовую расстановку без пересоздания тел (restore исходного снимка).
+        void rerack();
+
+        [[nodiscard]] physics::SlotMap<physics::Ball>&       balls()         { return m_balls; }
+        [[nodiscard]] const physics::SlotMap<physics::Ball>& balls()   const { return m_balls; }
+        [[nodiscard]] physics::SlotHandle                    cue()     const { return m_cue; }
+        [[nodiscard]] const std::vector<physics::Pocket>&    pockets() const { return m_pockets; }
+        [[nodiscard]] physics::World&                        world()         { return m_world; }
+        [[nodiscard]] const physics::World&                  world()   const { return m_world; }
+        [[nodiscard]] const TableConfig&                     config()  const { return m_cfg; }
+        [[nodiscard]] int                                    score()   const { return m_score; }
+
+    private:
+        void rack();
+        void settle();
+        int  potBalls();
+
+        TableConfig                     m_cfg;
+        physics::World                  m_world;    // объявлен раньше шаров: уничтожается последним
+        physics::Table                  m_table;
+        physics::SlotMap<physics::Ball> m_balls;    // забитые остаются здесь выключенными
+        physics::SlotHandle             m_cue;
+        Snapshot                        m_rack;     // расстановка сразу после rack()
+        std::vector<physics::Pocket>    m_pockets;
+        std::vector<int>                m_lastPotted;
+        int                             m_lastSubsteps = 0;
+        int                             m_score = 0;
+    };
+
+} // namespace sim
+
+#endif //SIMULATION_HPP
@@ -0,0 +1,56 @@
+#ifndef TRIPLEBUFFER_HPP
+#define TRIPLEBUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+
+namespace sim {
+
+    /// Тройной буфер «один писатель — один читатель» без блокировок.
+    ///
+    /// Писатель заполняет write() и вызывает publish(); читатель вызывает fetch() и
+    /// читает read(). Три слота: у каждой стороны свой, третий («средний») лежит
+    /// в атомике вместе с флагом свежести и меняется обменом. Никто никого не ждёт:
+    /// писатель не блокируется медленным читателем (промежуточные состояния просто
+    /// перезаписываются), читатель всегда видит последнее целиком опубликованное.
+    ///
+    /// Слоты переиспользуются — T с векторами внутри (BallStore) после первых
+    /// кадров копируется без аллокаций.
+    template<class T>
+    class TripleBuffer {
+    public:
+        /// Слот писателя. Содержимое — то, что писатель опубликовал два раза назад
+        /// (или по умолчанию), поэтому заполнять его нужно целиком.
+        T& write() { return m_slots[m_write]; }
+
+        /// Отдать write() читателю; писатель получает освободившийся слот.
+        void publish()
+        {
+            m_write = m_middle.exchange(std::uint8_t(m_write | kFresh), std::memory_order_acq_rel) & kIndex;
+        }
+
+        /// Забрать последнее опубликованное состояние. false — нового нет, read() прежний.
+        bool fetch()
+        {
+            if (!(m_middle.load(std::memory_order_relaxed) & kFresh)) return false;
+            m_read = m_middle.exchange(m_read, std::memory_order_acq_rel) & kIndex;
+            return true;
+        }
+
+        /// Слот читателя: неизменен до следующего fetch().
+        [[nodiscard]] const T& read() const { return m_slots[m_read]; }
+
+    private:
+        static constexpr std::uint8_t kIndex = 0x3;
+        static constexpr std::uint8_t kFresh = 0x4;
+
+        std::array<T, 3>          m_slots{};
+        std::uint8_t              m_write = 0;        // только писатель
+        std::uint8_t              m_read  = 1;        // только читатель
+        std::atomic<std::uint8_t> m_middle{ 2 };      // индекс | kFresh
+    };
+
+} // namespace sim
+
+#endif //TRIPLEBUFFER_HPP
@@ -0,0 +1,31 @@
+#version 330 core
+
+// Трассировка сферы для импостора: пересечение луча из камеры (0,0,0 в системе
+// камеры) со сферой, точная глубина через gl_FragDepth и нормаль для освещения.
+in vec3  vViewPos;
+flat in vec3  vCenter;
+flat in float vRadius;
+
+uniform mat4 uProj;
+uniform vec3 uColor;
+
+out vec4 FragColor;
+
+void main()
+{
+    vec3  dir  = normalize(vViewPos);
+    float b    = dot(dir, vCenter);
+    float disc = b * b - (dot(vCenter, vCenter) - vRadius * vRadius);
+    if (disc < 0.0) discard;                       // луч мимо — за силуэтом
+
+    vec3 hit    = (b - sqrt(disc)) * dir;          // ближнее пересечение
+    vec3 normal = (hit - vCenter) / vRadius;
+
+    vec4 clip    = uProj * vec4(hit, 1.0);
+    gl_FragDepth = 0.5 * (clip.z / clip.w) + 0.5;  // glDepthRange по умолчанию (0, 1)
+
+    // Свет — направленный, из-за левого плеча камеры
+    const vec3 kLight = normalize(vec3(-0.4, 0.8, 0.6));
+    float diffuse = max(dot(normal, kLight), 0.0);
+    FragColor = vec4(uColor * (0.25 + 0.75 * diffuse), 1.0);
+}
@@ -0,0 +1,35 @@
+#version 330 core
+
+// Шар-импостор: квадрат, развёрнутый к камере, вместо треугольной сферы.
+// Сфера трассируется во фрагментном шейдере; здесь только строим квадрат,
+// гарантированно закрывающий её силуэт в перспективе.
+layout(location = 0) in vec2 aCorner;         // (±1, ±1)
+layout(location = 2) in vec4 iCenterRadius;   // xyz — центр (м), w — радиус (м)
+
+uniform mat4 uView;
+uniform mat4 uProj;
+
+out vec3  vViewPos;      // точка квадрата в системе камеры — по ней идёт луч
+flat out vec3  vCenter;  // центр сферы в системе камеры
+flat out float vRadius;
+
+void main()
+{
+    vec3  c = (uView * vec4(iCenterRadius.xyz, 1.0)).xyz;
+    float r = iCenterRadius.w;
+
+    // Касательный конус из камеры пересекает плоскость центра по кругу
+    // радиуса r·d/sqrt(d²−r²) — квадрат такого размера накрывает силуэт целиком.
+    float d2    = dot(c, c);
+    float scale = r * sqrt(d2 / max(d2 - r * r, 1e-6));
+
+    // Квадрат перпендикулярен лучу на центр, чтобы не срезать края сбоку экрана
+    vec3 fwd   = normalize(c);
+    vec3 right = normalize(cross(fwd, vec3(0.0, 1.0, 0.0)) + vec3(1e-6, 0.0, 0.0));
+    vec3 up    = cross(right, fwd);
+
+    vViewPos = c + scale * (aCorner.x * right + aCorner.y * up);
+    vCenter  = c;
+    vRadius  = r;
+    gl_Position = uProj * vec4(vViewPos, 1.0);
+}
@@ -1,15 +1,18 @@
 #version 330 core
 
-// Минимальный проходной вершинный шейдер.
-// Просто принимает позицию и передаёт её дальше.
+// Вершинный шейдер с инстансингом: один draw call на все шары.
+// Меш — единичная сфера; центр и радиус приходят атрибутом на экземпляр.
+// Для стола атрибут экземпляра не включён — берётся константа (0, 0, 0, 1),
+// т.е. вершина остаётся на месте.
 layout(location = 0) in vec3 aPos;
+layout(location = 1) in vec3 aNormal;
+layout(location = 2) in vec4 iCenterRadius;   // xyz — центр (м), w — радиус (м)
 
-uniform mat4 uModel;
 uniform mat4 uView;
 uniform mat4 uProj;
 
 void main()
 {
-    // Задаём gl_Position напрямую
-    gl_Position = uProj * uView * uModel * vec4(aPos, 1.0);
-}
\ No newline at end of file
+    vec3 world = iCenterRadius.xyz + iCenterRadius.w * aPos;
+    gl_Position = uProj * uView * vec4(world, 1.0);
+}
@@ -1,45 +1,30 @@
 #include "core/InputController.hpp"
-#include "Utils/Scale.hpp"   // Для px2m()
+#include "Utils/SfmlScale.hpp"   // Для px2m()
+#include "sim/Simulation.hpp"    // sim::shotImpulse
 #include <cmath>
-
-using physics::Ball;
+#include <limits>
 
 namespace core {
 
-/// Проверяет, что все шары полностью остановились (линейная и угловая скорости ниже порога).
-static bool allBallsStopped(const std::vector<Ball>& balls)
+/// Находит шар, центр которого ближе всего к точке ptM (в метрах). Возвращает слот или -1.
+int InputController::findBallUnder(const sf::Vector2f& ptM,
+                                   const physics::BallStore& balls) const
 {
-    const float vEps2 = px2m(3.f) * px2m(3.f);  // ≈ (3 px)² в м²/с²
-    const float wEps  = 0.01f;                  // 0.01 рад/с
-
-    for (const auto& b : balls) {
-        b2Body* body = b.body();
-        if (!body) continue;
-
-        if (body->GetLinearVelocity().LengthSquared() > vEps2)   return false;
-        if (std::abs(body->GetAngularVelocity()) > wEps)         return false;
-    }
-    return true;
-}
-
-/// Находит шар, центр которого ближе всего к точке ptM (в метрах).
-physics::Ball* InputController::findBallUnder(const sf::Vector2f& ptM,
-                                                  std::vector<Ball>& balls)
-{
-    Ball*  hit   = nullptr;
+    int    hit   = -1;
     float  best2 = std::numeric_limits<float>::max();
 
-    for (auto& b : balls) {
-        b2Vec2 cM = b.body()->GetPosition();       // в метрах
-        float  rM = px2m(b.radius());              // радиус в метрах
+    const int n = static_cast<int>(balls.size());
+    for (int i = 0; i < n; ++i) {
+        if (!balls.alive[i]) continue;
 
-        float dx = cM.x - ptM.x;
-        float dy = cM.y - ptM.y;
+        float dx = balls.x[i] - ptM.x;             // в метрах
+        float dy = balls.y[i] - ptM.y;
         float d2 = dx*dx + dy*dy;
+        float rM = balls.r[i];                     // радиус в метрах
 
         if (d2 <= rM*rM && d2 < best2) {
             best2 = d2;
-            hit   = &b;
+            hit   = i;
         }
     }
     return hit;
@@ -47,10 +32,11 @@ physics::Ball* InputController::findBallUnder(const sf::Vector2f& ptM,
 
 bool InputController::handleEvent(const sf::Event& ev,
                                   sf::RenderWindow& win,
-                                  std::vector<Ball>& balls)
+                                  const sim::FrameState& state,
+                                  sim::Shot& shot)
 {
     // Проверяем, все ли шары остановлены; если нет, новые нажатия ЛКМ игнорируются.
-    bool ready = allBallsStopped(balls);
+    bool ready = state.atRest;
 
     // ───── Нажатие ЛКМ ─────
     if (auto mb = ev.getIf<sf::Event::MouseButtonPressed>())
@@ -61,8 +47,9 @@ bool InputController::handleEvent(const sf::Event& ev,
             // Конвертируем пиксели → метры для поиска шара
             sf::Vector2f mouseM  = px2m(mousePx);
 
-            m_selected = findBallUnder(mouseM, balls);
-            if (m_selected) {
+            int slot = findBallUnder(mouseM, state.balls);
+            if (slot >= 0) {
+                m_selected = state.handles[slot];
                 m_dragging = true;
                 m_startPx = mousePx;   // сохраняем «точку начала» в пикселях
                 m_currPx  = mousePx;   // и текущую тоже
@@ -91,9 +78,10 @@ bool InputController::handleEvent(const sf::Event& ev,
             // 4) Получаем импульс (в Н·с)
             b2Vec2 impulse = computeImpulse(dragM);
 
-            // 5) Применяем к выбранному шару
-            m_selected->body()->ApplyLinearImpulseToCenter(impulse, true);
-            m_selected = nullptr;
+            // 5) Удар по выбранному шару; жив ли он ещё — проверит поток физики
+            shot.ball    = m_selected;
+            shot.impulse = impulse;
+            m_selected = {};
             return true;
         }
     }
@@ -103,15 +91,8 @@ bool InputController::handleEvent(const sf::Event& ev,
 
 b2Vec2 InputController::computeImpulse(const sf::Vector2f& dragM) const
 {
-    // dragM — в метрах
-    float len = std::hypot(dragM.x, dragM.y);
-    if (len < 1e-4f) return {0.f, 0.f};
-
-    float clamped = std::min(len, m_maxDrag);   // m_maxDrag уже в метрах
-    float scale   = (clamped / m_maxDrag) * m_maxImpulse; // m_maxImpulse в Н·с
-
-    sf::Vector2f dir = { dragM.x / len, dragM.y / len };
-    return { dir.x * scale, dir.y * scale };
+    // dragM — в метрах; формула общая с headless-симулятором
+    return sim::shotImpulse(toVec2(dragM), m_maxDrag, m_maxImpulse);
 }
 
 void InputController::drawAim(sf::RenderWindow& win) const
@@ -3,69 +3,109 @@
 #include <glad/glad.h>
 #include <iostream>
 #include <filesystem>
+#include <string_view>
 
 #include "render/GLRenderer.hpp"
-#include "physics/World.hpp"
-#include "physics/Table.hpp"
-#include "physics/Ball.hpp"
-#include "physics/Pockets.hpp"
+#include "render/Renderer.hpp"
+#include "sim/Simulation.hpp"
+#include "sim/SimThread.hpp"
+#include "replay/ReplayPlayer.hpp"
 #include "core/InputController.hpp"
 #include "core/ScoreBoard.hpp"
-#include "Utils/Scale.hpp"
+#include "prof/Profiler.hpp"
+#if defined(BILLIARDS_PROFILE)
+#include "core/ProfilerOverlay.hpp"
+#include "render/GpuTimer.hpp"
+#endif
 
-int main()
+namespace {
+
+    /// Шаги 2)–6): Glad, проверка shaders/ и GLRenderer. false — 3D на этой машине нет.
+    bool initGl(sf::RenderWindow& win, render::GLRenderer& glRenderer)
+    {
+        // 2) Активируем окно, чтобы Glad увидел контекст
+        if (!win.setActive(true)) {
+            std::cerr << "Failed to set SFML window active (for GL)\n";
+            return false;
+        }
+
+        // 3) Инициализируем Glad
+        if (!gladLoadGL()) {
+            std::cerr << "Failed to initialize GLAD\n";
+            return false;
+        }
+
+        // 4) Пока контекст активен, выводим реальную версию OpenGL/GLSL
+        std::cout << "OpenGL Vendor:   "
+                  << (const char*)glGetString(GL_VENDOR)   << "\n";
+        std::cout << "OpenGL Renderer: "
+                  << (const char*)glGetString(GL_RENDERER) << "\n";
+        std::cout << "OpenGL Version:  "
+                  << (const char*)glGetString(GL_VERSION)  << "\n";
+        std::cout << "GLSL Version:    "
+                  << (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION)
+                  << "\n";
+
+        // Контекст не деактивируем: GLRenderer::init и все кадры идут в этом же потоке
+        // (см. 10.3), переключать его незачем
+
+        // 5) Проверим, что папка shaders/ лежит рядом с .exe
+        std::cout << "Current working directory: "
+                  << std::filesystem::current_path() << "\n";
+        if (!std::filesystem::exists("shaders/phong.vert")) {
+            std::cerr << "Error: shaders/phong.vert not found in working directory\n";
+            std::cerr << "Make sure you used file(COPY \"${CMAKE_SOURCE_DIR}/shaders\" DESTINATION \"${CMAKE_BINARY_DIR}\") in CMakeLists.txt\n";
+            return false;
+        }
+
+        // 6) Создаём рендерер и пытаемся инициализировать 3D-шейдеры
+        //    (слинкованные программы кэшируются в shader_cache/ — второй запуск без компиляции)
+        if (!glRenderer.init("shaders", "shader_cache")) {
+            std::cerr << "Failed to initialize GLRenderer (shaders)\n";
+            return false;
+        }
+        glRenderer.resize(1280, 720);
+        return true;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
 {
-    // 1) Создаём окно SFML с контекстом OpenGL 3.3
+    // --2d — лёгкий вид сверху средствами SFML, без OpenGL 3.3 (слабые машины)
+    // --record FILE — писать партию в реплей (replay::ReplayWriter)
+    // --record-inputs FILE — писать только удары и контрольные хеши (replay::InputLog),
+    //                  хеш — на каждом тике: сверка называет ровно тик расхождения;
+    //                  смотреть: billiards_sim --verify FILE --record FILE.brpl
+    // --play FILE   — смотреть записанную партию: пробел — пауза, ←/→ — ±5 с, Home — начало
+    bool        topDown = false;
+    const char* recordPath = nullptr;
+    const char* inputsPath = nullptr;
+    const char* playPath   = nullptr;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string_view(argv[i]) == "--2d") topDown = true;
+        else if (std::string_view(argv[i]) == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (std::string_view(argv[i]) == "--play"   && i + 1 < argc) playPath   = argv[++i];
+        else if (std::string_view(argv[i]) == "--record-inputs" && i + 1 < argc) inputsPath = argv[++i];
+    }
+
+    // 1) Создаём окно SFML; для 3D — с контекстом OpenGL 3.3
     sf::RenderWindow win(
         sf::VideoMode{ sf::Vector2u{1280, 720}, 32u },
         "Billiards 3-D",
         sf::State::Windowed,
-        sf::ContextSettings{24, 8, 4, 3, 3}  // depth=24, stencil=8, AA=4, OpenGL 3.3
+        topDown ? sf::ContextSettings{0, 0, 4}          // AA=4, контекст любой
+                : sf::ContextSettings{24, 8, 4, 3, 3}   // depth=24, stencil=8, AA=4, OpenGL 3.3
     );
     win.setFramerateLimit(60);
 
-    // 2) Активируем окно, чтобы Glad увидел контекст
-    if (!win.setActive(true)) {
-        std::cerr << "Failed to set SFML window active (for GL)\n";
-        return -1;
-    }
-
-    // 3) Инициализируем Glad
-    if (!gladLoadGL()) {
-        std::cerr << "Failed to initialize GLAD\n";
-        return -1;
-    }
-
-    // 4) Пока контекст активен, выводим реальную версию OpenGL/GLSL
-    std::cout << "OpenGL Vendor:   "
-              << (const char*)glGetString(GL_VENDOR)   << "\n";
-    std::cout << "OpenGL Renderer: "
-              << (const char*)glGetString(GL_RENDERER) << "\n";
-    std::cout << "OpenGL Version:  "
-              << (const char*)glGetString(GL_VERSION)  << "\n";
-    std::cout << "GLSL Version:    "
-              << (const char*)glGetString(GL_SHADING_LANGUAGE_VERSION)
-              << "\n";
-
-    // После того, как мы убедились, какая версия, можно деактивировать контекст
-    win.setActive(false);
-
-    // 5) Проверим, что папка shaders/ лежит рядом с .exe
-    std::cout << "Current working directory: "
-              << std::filesystem::current_path() << "\n";
-    if (!std::filesystem::exists("shaders/phong.vert")) {
-        std::cerr << "Error: shaders/phong.vert not found in working directory\n";
-        std::cerr << "Make sure you used file(COPY \"${CMAKE_SOURCE_DIR}/shaders\" DESTINATION \"${CMAKE_BINARY_DIR}\") in CMakeLists.txt\n";
-        return -1;
-    }
-
-    // 6) Создаём рендерер и пытаемся инициализировать 3D-шейдеры
+    // 2)–6) GL 3.3 и 3D-рендер. Не вышло — не выходим, а остаёмся в 2D
     render::GLRenderer glRenderer;
-    if (!glRenderer.init("shaders")) {
-        std::cerr << "Failed to initialize GLRenderer (shaders)\n";
-        return -1;
-    }
-    glRenderer.resize(1280, 720);
+    const bool glReady = !topDown && initGl(win, glRenderer);
+    if (!topDown && !glReady)
+        std::cerr << "3D renderer unavailable, falling back to 2D top-down view (--2d)\n";
+    topDown = topDown || !glReady;
+    render::Renderer topDownRenderer;
 
     // 7) Загружаем шрифт и настраиваем 2D-счёт
     sf::Font font;
@@ -75,104 +115,147 @@ int main()
     }
     core::ScoreBoard scoreboard(font);
 
-    // 8) Физический мир, стол, шары
-    physics::World world;
-    physics::Table table(world.raw(), 1280.f, 720.f, /*offsetPx=*/20.f);
-
-    std::vector<physics::Ball> balls;
-    const sf::Vector2f cueStartPx{300.f, 360.f};
-    balls.emplace_back(world.raw(), 10.f, cueStartPx);
-
-    // Пирамида из 15 шаров
-    const float R   = 10.f;
-    const float GAP = 0.5f;
-    const float STEPX = (2.f * R + GAP) * 0.8660254f;
-    const float BASEY = 360.f;
-    const float BASEx = 900.f;
-    for (int row = 0; row < 5; ++row) {
-        float x  = BASEx + STEPX * row;
-        float y0 = BASEY - row * (R + GAP / 2.f);
-        for (int col = 0; col <= row; ++col) {
-            float y = y0 + col * (2.f * R + GAP);
-            balls.emplace_back(world.raw(), R, sf::Vector2f{x, y});
-        }
-    }
-
-    // 9) Карманы
-    auto pockets = physics::defaultPockets(1280.f, 720.f, /*rPx=*/18.f);
+    // 8) Физический мир, стол, шары и карманы (общий с billiards_sim код)
+    sim::Simulation table;
+    const sim::TableConfig& cfg = table.config();
 
-    // 10) Контроллер ввода
+    // 9) Контроллер ввода
     core::InputController input(/*maxDrag_m=*/2.0f, /*maxImpulse=*/0.2f);
 
-    const float dt = 1.0f / 120.0f;
-    sf::Clock clk;
+    // Физика — в своём потоке ровно по 1/60 с; кадр берёт последний готовый снимок
+    // и не ждёт её, кадры ограничивает только setFramerateLimit. Между шагами шары
+    // интерполируются, а точность держат адаптивные подшаги Simulation::tick.
+    // Реплей объявлен раньше потока физики: тот пишет в него до самой остановки
+    replay::ReplayWriter  recorder;
+    replay::InputRecorder inputs;
+    sim::SimThread simThread(table, 1.0f / 60.0f);
+
+    // Реплей вместо игры: физика не запускается, кадры берутся из файла
+    replay::ReplayPlayer player;
+    const bool playing = playPath != nullptr;
+    if (playing && !player.open(playPath)) {
+        std::cerr << "Cannot open replay " << playPath << "\n";
+        return 1;
+    }
 
-    // 11) Главный цикл
+    // Тики кодирует поток физики, на диск пишет фоновый поток самого писателя
+    if (recordPath && !playing) {
+        if (recorder.open(recordPath, simThread.step(), physics::kBallLinearDamping))
+            simThread.setRecorder(&recorder);
+        else
+            std::cerr << "Cannot open replay file " << recordPath << "\n";
+    }
+    if (inputsPath && !playing) {
+        inputs.begin(table, simThread.step(), 1);   // 4 байта на тик движения — партия всё равно в килобайтах
+        simThread.setInputRecorder(&inputs);
+    }
+
+#if defined(BILLIARDS_PROFILE)
+    // Профайлер: зоны кадра и потока физики, время GPU на 3D-проход
+    prof::Profiler& profiler = prof::Profiler::instance();
+    profiler.openCsv("profile.csv");
+    profiler.openChromeTrace("profile.trace.json");
+    core::ProfilerOverlay profOverlay(font);
+    render::GpuTimer      gpuTimer;
+#endif
+    if (!playing) simThread.start();
+    sf::Clock frameClock;
+
+    // 10) Главный цикл
     while (win.isOpen()) {
-        // 11.1  События
-        while (auto e = win.pollEvent()) {
-            if (e->is<sf::Event::Closed>()) {
-                win.close();
-            }
-            input.handleEvent(*e, win, balls);
-        }
+        const sim::FrameState& state = simThread.latest();
+        player.update(frameClock.restart().asSeconds());
 
-        // 11.2  Физика
-        for (int i = 0; i < 4; ++i)
-            world.step(dt / 4.0f);
-
-        const float vEps2 = px2m(3.f) * px2m(3.f);
-        const float wEps  = 0.01f;
-        for (auto& b : balls) {
-            b2Body* body = b.body();
-            if (!body) continue;
-            bool slowLin = body->GetLinearVelocity().LengthSquared() < vEps2;
-            bool slowAng = std::abs(body->GetAngularVelocity()) < wEps;
-            if (slowLin) body->SetLinearVelocity({0, 0});
-            if (slowAng) body->SetAngularVelocity(0);
-            if (slowLin && slowAng) body->SetAwake(false);
-        }
+        // Что рисуем: живой стол или реплей
+        const physics::BallStore& prevBalls = playing ? player.prev()  : state.prev;
+        const physics::BallStore& currBalls = playing ? player.curr()  : state.balls;
+        const float               alpha     = playing ? player.alpha() : simThread.alpha(state);
 
-        // 11.3  Проверка карманов
-        for (auto it = balls.begin(); it != balls.end();) {
-            bool potted = false;
-            for (auto& pocket : pockets) {
-                if (physics::inPocket(pocket, *it)) {
-                    potted = true;
-                    break;
+        // 10.1  События
+        {
+            PROFILE_ZONE("input");
+            while (auto e = win.pollEvent()) {
+                if (e->is<sf::Event::Closed>()) {
+                    win.close();
                 }
-            }
-            if (potted) {
-                if (&(*it) == &balls.front()) {
-                    b2Body* b = it->body();
-                    b->SetTransform(
-                        { px2m(cueStartPx.x), px2m(cueStartPx.y) }, 0.f
-                    );
-                    b->SetLinearVelocity({0, 0});
-                    ++it;
-                } else {
-                    world.raw().DestroyBody(it->body());
-                    it = balls.erase(it);
-                    scoreboard.increase();
+                // I — переключить шары: треугольные сферы ↔ импосторы
+                if (const auto* key = e->getIf<sf::Event::KeyPressed>();
+                    key && key->code == sf::Keyboard::Key::I) {
+                    glRenderer.setBallMode(glRenderer.ballMode() == render::BallMode::Mesh
+                                           ? render::BallMode::Impostor
+                                           : render::BallMode::Mesh);
+                }
+                // T — 3D ↔ вид сверху (если 3D вообще поднялся)
+                if (const auto* key = e->getIf<sf::Event::KeyPressed>();
+                    key && key->code == sf::Keyboard::Key::T && glReady) {
+                    topDown = !topDown;
+                    if (topDown) win.resetGLStates();   // после GLRenderer кэш состояний SFML устарел
                 }
-            } else ++it;
+                if (playing) {
+                    if (const auto* key = e->getIf<sf::Event::KeyPressed>()) {
+                        if (key->code == sf::Keyboard::Key::Space) player.togglePause();
+                        if (key->code == sf::Keyboard::Key::Left)  player.seek(player.time() - 5.0);
+                        if (key->code == sf::Keyboard::Key::Right) player.seek(player.time() + 5.0);
+                        if (key->code == sf::Keyboard::Key::Home)  player.seek(0.0);
+                    }
+                } else if (sim::Shot shot; input.handleEvent(*e, win, state, shot)) {
+                    simThread.post(shot);
+                }
+            }
         }
 
-        // 11.4  Рендер 3D
-        win.setActive(true);
-        glViewport(0, 0, 1280, 720);
-        glRenderer.drawScene(balls, pockets, 1280.f, 720.f);
-        win.setActive(false);
+        // 10.2  Счёт по снимку (кадр мог пропустить несколько шагов физики)
+        scoreboard.set(playing ? player.score() : state.score);
 
-        // 11.5  HUD 2D
-        win.pushGLStates();
-        scoreboard.draw(win);
-        input.drawAim(win);
-        win.popGLStates();
+        // 10.3  Сцена. Вид сверху — одним sf::VertexArray, без GL 3.3
+        if (topDown) {
+            PROFILE_ZONE("drawScene");
+            win.clear(sf::Color::Black);
+            topDownRenderer.drawScene(win, prevBalls, currBalls, alpha,
+                                      table.pockets(), cfg.widthPx, cfg.heightPx);
+        }
+        // Рендер 3D. Контекст окна активен с самого начала — в этом потоке
+        // он единственный, переключать его каждый кадр не нужно
+        else {
+            PROFILE_ZONE("drawScene");
+#if defined(BILLIARDS_PROFILE)
+            gpuTimer.begin();
+#endif
+            glViewport(0, 0, 1280, 720);
+            glRenderer.drawScene(prevBalls, currBalls, alpha,
+                                 table.pockets(), cfg.widthPx, cfg.heightPx);
+#if defined(BILLIARDS_PROFILE)
+            gpuTimer.end();
+            if (double gpuMs; gpuTimer.latest(gpuMs))
+                profiler.recordValue("gpu.scene", gpuMs);
+#endif
+        }
+
+        // 10.4  HUD 2D
+        {
+            PROFILE_ZONE("hud");
+            win.pushGLStates();
+            scoreboard.draw(win);
+            input.drawAim(win);
+#if defined(BILLIARDS_PROFILE)
+            profOverlay.update(profiler);
+            profOverlay.draw(win);
+#endif
+            win.popGLStates();
+        }
 
-        win.display();
-        sf::sleep(sf::seconds(dt) - clk.restart());
+        {
+            PROFILE_ZONE("display");
+            win.display();
+        }
+        PROFILE_FRAME();
     }
 
+    // Журнал ввода дописан, только когда поток физики стоит
+    if (inputsPath && !playing) {
+        simThread.stop();
+        if (inputs.log().save(inputsPath) == 0)
+            std::cerr << "Cannot write input replay " << inputsPath << "\n";
+    }
     return 0;
 }
@@ -1,9 +1,10 @@
 #include "physics/Ball.hpp"
+#include "physics/World.hpp"
 
 namespace physics {
 
     // Конструктор: получаем р-р и позицию в пикселях, переводим в метры
-    Ball::Ball(b2World& world, float rPix, const sf::Vector2f& posPix)
+    Ball::Ball(World& world, float rPix, const Vec2f& posPix)
         : m_world(world)
         , m_radiusPx(rPix)
     {
@@ -16,9 +17,9 @@ namespace physics {
         b2BodyDef bd;
         bd.type          = b2_dynamicBody;
         bd.position.Set(px, py);
-        bd.linearDamping  = 0.9f;  // сильное демпфирование
+        bd.linearDamping  = kBallLinearDamping;  // сильное демпфирование
         bd.angularDamping = 0.9f;
-        m_body = m_world.CreateBody(&bd);
+        m_body = m_world.raw().CreateBody(&bd);
 
         // 3) Форма — круг
         b2CircleShape circle;
@@ -32,15 +33,20 @@ namespace physics {
         fd.restitution = 0.93f;    // заметный отскок
 
         m_body->CreateFixture(&fd);
+
+        // 5) Регистрируем шар в SoA-зеркале мира
+        m_slot = m_world.addBall(m_body, r);
     }
 
     // Move-конструктор
     Ball::Ball(Ball&& other) noexcept
         : m_world(other.m_world)
         , m_body(other.m_body)
+        , m_slot(other.m_slot)
         , m_radiusPx(other.m_radiusPx)
     {
         other.m_body = nullptr;
+        other.m_slot = -1;
     }
 
     // Move-assignment
@@ -50,13 +56,15 @@ namespace physics {
 
         // Удаляем своё тело, если есть
         if (m_body) {
-            m_world.DestroyBody(m_body);
+            m_world.removeBall(m_slot);
         }
 
         m_body     = other.m_body;
+        m_slot     = other.m_slot;
         m_radiusPx = other.m_radiusPx;
 
         other.m_body = nullptr;
+        other.m_slot = -1;
         return *this;
     }
 
@@ -64,7 +72,7 @@ namespace physics {
     Ball::~Ball()
     {
         if (m_body) {
-            m_world.DestroyBody(m_body);
+            m_world.removeBall(m_slot);
         }
     }
 
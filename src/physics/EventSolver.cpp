@@ -0,0 +1,471 @@
+#include "physics/EventSolver.hpp"
+#include "physics/Ball.hpp"    // kRestLinearSpeed / kRestAngularSpeed
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace physics {
+
+namespace {
+    constexpr double kNever = std::numeric_limits<double>::infinity();
+
+    /// Скорость сближения (м/с) ниже этой считаем нулевой. За всё время торможения
+    /// (путь v/c при c ≈ 0.9) такое сближение съест меньше b2_linearSlop (5 мм),
+    /// а без порога неупругие цепочки касающихся шаров в пирамиде порождают
+    /// бесконечную серию столкновений с геометрически убывающими скоростями.
+    constexpr double kApproachEps = 0.004;
+
+    /// Порог упругого отскока, как b2FixtureDef::restitutionThreshold (1 м/с).
+    constexpr float kRestitutionThreshold = 1.0f;
+
+    /// Защитный предел событий за один advance(): неупругий «коллапс» плотного
+    /// кластера может порождать бесконечную серию столкновений в одной точке.
+    constexpr int kMaxEventsPerStep = 100000;
+
+    /// Время τ, за которое шар с демпфированием c проходит «путь без демпфирования» s:
+    /// s = (1 − e^(−c·τ)) / c  ⇒  τ = −ln(1 − c·s) / c. Если c·s ≥ 1 — не дойдёт никогда.
+    double pathToTime(double s, double c)
+    {
+        if (c <= 0.0) return s;
+        double x = c * s;
+        if (x >= 1.0) return kNever;
+        return -std::log1p(-x) / c;
+    }
+
+    /// Обратное к pathToTime: множитель пути F(τ) = (1 − e^(−c·τ)) / c.
+    double timeToPath(double tau, double c)
+    {
+        if (c <= 0.0) return tau;
+        return -std::expm1(-c * tau) / c;
+    }
+
+    bool isZero(const b2Vec2& v) { return v.x == 0.f && v.y == 0.f; }
+}
+
+// ─── Синхронизация с b2World ─────────────────────────────────────
+
+void EventSolver::syncFromWorld()
+{
+    // Без выделений памяти: буферы — члены класса, борта и карманы
+    // пересобираются, только если поменялся набор статических тел
+    m_seen.assign(m_balls.size(), 0);
+    bool        staticsChanged = false;
+    std::size_t staticCount    = 0;
+
+    for (b2Body* b = m_world.GetBodyList(); b; b = b->GetNext()) {
+        // Статическое тело: сверяем с тем, что было на прошлом шаге
+        if (b->GetType() == b2_staticBody) {
+            const StaticKey key{ b, b->GetFixtureList(), b->GetPosition(), b->GetAngle() };
+            if (staticCount == m_statics.size()) {
+                m_statics.push_back(key);
+                staticsChanged = true;
+            } else if (StaticKey& old = m_statics[staticCount];
+                       old.body != key.body || old.fixtures != key.fixtures ||
+                       old.position != key.position || old.angle != key.angle) {
+                old = key;
+                staticsChanged = true;
+            }
+            ++staticCount;
+            continue;
+        }
+
+        // Шары: динамические тела с круглой фикстурой
+        if (b->GetType() != b2_dynamicBody || !b->IsEnabled()) continue;
+        b2Fixture* f = b->GetFixtureList();
+        if (!f || f->GetType() != b2Shape::e_circle) continue;
+
+        auto it = m_index.find(b);
+        int  i  = (it != m_index.end()) ? it->second : addBall(b);
+        if (i >= static_cast<int>(m_seen.size())) m_seen.resize(i + 1, 0);
+        m_seen[i] = 1;
+
+        // Кто-то трогал тело снаружи (удар, возврат битка, гашение скоростей)?
+        const BallState& s = m_balls[i];
+        if (b->GetPosition()        != s.writtenP ||
+            b->GetLinearVelocity()  != s.writtenV ||
+            b->GetAngularVelocity() != s.writtenW)
+            resetBall(i);
+    }
+    if (staticCount != m_statics.size()) {
+        m_statics.resize(staticCount);
+        staticsChanged = true;
+    }
+
+    // Тела, которых больше нет в мире (забитые шары)
+    for (int i = 0; i < static_cast<int>(m_balls.size()); ++i) {
+        BallState& s = m_balls[i];
+        if (!s.alive || (i < static_cast<int>(m_seen.size()) && m_seen[i])) continue;
+        m_index.erase(s.body);
+        s.alive = false;
+        s.body  = nullptr;
+        ++s.version;
+        m_freeSlots.push_back(i);
+    }
+
+    // Борта или карманы поменялись — все предсказания с ними недействительны
+    if (staticsChanged) {
+        collectStatics();
+        m_queue = {};
+        for (int i = 0; i < static_cast<int>(m_balls.size()); ++i)
+            if (m_balls[i].alive) { ++m_balls[i].version; predict(i); }
+    }
+}
+
+void EventSolver::collectStatics()
+{
+    m_walls.clear();
+    m_pockets.clear();
+    for (const StaticKey& key : m_statics) {
+        // Борта: рёбра статических тел; карманы: их круглые сенсоры
+        const b2Transform& xf = key.body->GetTransform();
+        for (b2Fixture* f = key.fixtures; f; f = f->GetNext()) {
+            if (f->IsSensor() && f->GetType() == b2Shape::e_circle && f->GetUserData().pointer) {
+                auto* circle = static_cast<b2CircleShape*>(f->GetShape());
+                m_pockets.push_back({ b2Mul(xf, circle->m_p), circle->m_radius,
+                                      static_cast<int>(f->GetUserData().pointer) - 1 });
+                continue;
+            }
+            if (f->IsSensor() || f->GetType() != b2Shape::e_edge) continue;
+            auto* edge = static_cast<b2EdgeShape*>(f->GetShape());
+            b2Vec2 a = b2Mul(xf, edge->m_vertex1);
+            b2Vec2 d = b2Mul(xf, edge->m_vertex2) - a;
+            float len = d.Length();
+            if (len <= 0.f) continue;
+            b2Vec2 t = (1.f / len) * d;
+            m_walls.push_back({ a, t, b2Vec2(-t.y, t.x), len });
+        }
+    }
+}
+
+int EventSolver::addBall(b2Body* body)
+{
+    int i;
+    if (!m_freeSlots.empty()) {
+        i = m_freeSlots.back();
+        m_freeSlots.pop_back();
+    } else {
+        i = static_cast<int>(m_balls.size());
+        m_balls.emplace_back();
+    }
+
+    BallState& s  = m_balls[i];
+    b2Fixture* f  = body->GetFixtureList();
+    float mass    = body->GetMass();
+    s.body        = body;
+    s.radius      = f->GetShape()->m_radius;
+    s.damping     = body->GetLinearDamping();
+    s.angDamp     = body->GetAngularDamping();
+    s.invMass     = mass > 0.f ? 1.f / mass : 0.f;
+    s.restitution = f->GetRestitution();
+    s.alive       = true;
+    m_index[body] = i;
+
+    resetBall(i);
+    return i;
+}
+
+/// Перечитывает состояние шара из тела и заново предсказывает его события.
+void EventSolver::resetBall(int i)
+{
+    BallState& s = m_balls[i];
+    b2Body*    b = s.body;
+
+    s.t0       = m_now;
+    s.p0       = b->GetPosition();
+    s.v0       = b->GetLinearVelocity();
+    s.angle0   = b->GetAngle();
+    s.w0       = b->GetAngularVelocity();
+    s.writtenP = s.p0;
+    s.writtenV = s.v0;
+    s.writtenW = s.w0;
+
+    float speed = s.v0.Length();
+    if (speed <= kRestLinearSpeed) {
+        s.v0.SetZero();
+        s.restAt = kNever;
+    } else {
+        s.restAt = (s.damping > 0.f) ? m_now + std::log(speed / kRestLinearSpeed) / s.damping : kNever;
+    }
+
+    ++s.version;
+    predict(i);
+
+    // Шар поставили прямо в карман — событие входа уже не наступит, сообщаем сразу
+    for (const auto& z : m_pockets)
+        if ((s.p0 - z.center).LengthSquared() <= z.radius * z.radius)
+            m_pocketHits.push_back({ s.body, z.index });
+}
+
+// ─── Кинематика ──────────────────────────────────────────────────
+
+void EventSolver::stateAt(const BallState& s, double t, b2Vec2& p, b2Vec2& v) const
+{
+    if (isZero(s.v0)) { p = s.p0; v.SetZero(); return; }
+
+    double tau = std::min(t, s.restAt) - s.t0;
+    float  F   = static_cast<float>(timeToPath(tau, s.damping));
+    float  k   = static_cast<float>(std::exp(-s.damping * tau));
+    p = s.p0 + F * s.v0;
+    v = (t >= s.restAt) ? b2Vec2(0.f, 0.f) : k * s.v0;
+}
+
+void EventSolver::moveTo(int i, double t)
+{
+    BallState& s = m_balls[i];
+    b2Vec2 p, v;
+    stateAt(s, t, p, v);
+
+    double tau = t - s.t0;
+    s.angle0 += s.w0 * static_cast<float>(timeToPath(tau, s.angDamp));
+    s.w0     *= static_cast<float>(std::exp(-s.angDamp * tau));
+    s.p0      = p;
+    s.v0      = v;
+    s.t0      = t;
+}
+
+// ─── Предсказание событий ────────────────────────────────────────
+
+void EventSolver::predict(int i)
+{
+    const BallState& s = m_balls[i];
+    if (!s.alive) return;
+
+    if (s.restAt < kNever)
+        m_queue.push({ s.restAt, EventType::Rest, i, -1, s.version, 0 });
+
+    for (int j = 0; j < static_cast<int>(m_balls.size()); ++j)
+        if (j != i && m_balls[j].alive) predictPair(i, j);
+
+    for (int w = 0; w < static_cast<int>(m_walls.size()); ++w)
+        predictWall(i, w);
+
+    for (int k = 0; k < static_cast<int>(m_pockets.size()); ++k)
+        predictPocket(i, k);
+}
+
+void EventSolver::predictPair(int i, int j)
+{
+    const BallState& A = m_balls[i];
+    const BallState& B = m_balls[j];
+    bool movA = !isZero(A.v0), movB = !isZero(B.v0);
+    if (!movA && !movB) return;
+
+    b2Vec2 pa, va, pb, vb;
+    stateAt(A, m_now, pa, va);
+    stateAt(B, m_now, pb, vb);
+
+    // Оба шара тормозят с одним c, поэтому Δp(τ) = Δp + Δv·F(τ) — прямая по параметру s = F(τ)
+    double c  = movA ? A.damping : B.damping;
+    double dx = pb.x - pa.x,  dy = pb.y - pa.y;
+    double ux = vb.x - va.x,  uy = vb.y - va.y;
+    double R  = A.radius + B.radius;
+
+    double b = dx * ux + dy * uy;
+    if (b >= -kApproachEps * std::sqrt(dx * dx + dy * dy)) return;   // не сближаются
+
+    double a  = ux * ux + uy * uy;
+    double cc = dx * dx + dy * dy - R * R;
+    double s;
+    if (cc <= 0.0) {
+        s = 0.0;                                 // уже касаются и сближаются
+    } else {
+        double disc = b * b - a * cc;
+        if (disc < 0.0) return;                  // промах
+        s = (-b - std::sqrt(disc)) / a;
+    }
+
+    double t = m_now + pathToTime(s, c);
+    if (t > std::min(A.restAt, B.restAt)) return; // кто-то остановится раньше
+
+    m_queue.push({ t, EventType::BallBall, i, j, A.version, B.version });
+}
+
+void EventSolver::predictWall(int i, int w)
+{
+    const BallState& S = m_balls[i];
+    if (isZero(S.v0)) return;
+
+    const Wall& W = m_walls[w];
+    b2Vec2 p, v;
+    stateAt(S, m_now, p, v);
+
+    double d0   = b2Dot(W.n, p - W.a);
+    double side = d0 >= 0.0 ? 1.0 : -1.0;
+    double dist = side * d0;
+    double vn   = side * b2Dot(W.n, v);
+    if (vn >= -kApproachEps) return;             // удаляется от борта
+
+    double s = (dist <= S.radius) ? 0.0 : (dist - S.radius) / -vn;
+
+    // Точка касания должна лежать в пределах отрезка
+    double along = b2Dot(W.t, p - W.a) + s * b2Dot(W.t, v);
+    if (along < 0.0 || along > W.length) return;
+
+    double t = m_now + pathToTime(s, S.damping);
+    if (t > S.restAt) return;
+
+    m_queue.push({ t, EventType::BallWall, i, w, S.version, 0 });
+}
+
+void EventSolver::predictPocket(int i, int k)
+{
+    const BallState& S = m_balls[i];
+    if (isZero(S.v0)) return;
+
+    const PocketZone& Z = m_pockets[k];
+    b2Vec2 p, v;
+    stateAt(S, m_now, p, v);
+
+    // Тот же отрезок, что и для пары шаров, только второй «шар» неподвижен
+    double dx = p.x - Z.center.x, dy = p.y - Z.center.y;
+    double b  = dx * v.x + dy * v.y;
+    double cc = dx * dx + dy * dy - double(Z.radius) * Z.radius;
+    if (cc <= 0.0 || b >= 0.0) return;           // уже внутри или удаляется
+
+    double a    = double(v.x) * v.x + double(v.y) * v.y;
+    double disc = b * b - a * cc;
+    if (disc < 0.0) return;
+    double s = (-b - std::sqrt(disc)) / a;
+
+    double t = m_now + pathToTime(s, S.damping);
+    if (t > S.restAt) return;
+
+    m_queue.push({ t, EventType::PocketEnter, i, k, S.version, 0 });
+}
+
+// ─── Реакция на события ──────────────────────────────────────────
+
+void EventSolver::resolveBallBall(int i, int j)
+{
+    BallState& A = m_balls[i];
+    BallState& B = m_balls[j];
+
+    b2Vec2 n = B.p0 - A.p0;
+    if (n.Normalize() <= 0.f) return;
+
+    float vn = b2Dot(A.v0 - B.v0, n);            // скорость сближения вдоль нормали
+    if (vn <= 0.f) return;
+
+    // Restitution смешивается как в Box2D: max, и обнуляется ниже порога
+    float e = (vn < kRestitutionThreshold) ? 0.f : std::max(A.restitution, B.restitution);
+    float J = (1.f + e) * vn / (A.invMass + B.invMass);
+
+    A.v0 -= (J * A.invMass) * n;
+    B.v0 += (J * B.invMass) * n;
+}
+
+void EventSolver::resolveBallWall(int i, int w)
+{
+    BallState&  S = m_balls[i];
+    const Wall& W = m_walls[w];
+
+    float side = b2Dot(W.n, S.p0 - W.a) >= 0.f ? 1.f : -1.f;
+    b2Vec2 n   = side * W.n;                      // нормаль в сторону шара
+    float  vn  = b2Dot(S.v0, n);
+    if (vn >= 0.f) return;
+
+    float e = (-vn < kRestitutionThreshold) ? 0.f : S.restitution;
+    S.v0 -= ((1.f + e) * vn) * n;
+}
+
+// ─── Основной цикл ───────────────────────────────────────────────
+
+void EventSolver::advance(float dt)
+{
+    syncFromWorld();
+
+    const double target = m_now + dt;
+    int processed = 0;
+
+    while (!m_queue.empty() && m_queue.top().time <= target && processed < kMaxEventsPerStep) {
+        Event e = m_queue.top();
+        m_queue.pop();
+
+        // Устаревшие события (траектория шара уже поменялась) пропускаем
+        const BallState& A = m_balls[e.a];
+        if (!A.alive || A.version != e.versionA) continue;
+        if (e.type == EventType::BallBall) {
+            const BallState& B = m_balls[e.b];
+            if (!B.alive || B.version != e.versionB) continue;
+        }
+
+        m_now = std::max(m_now, e.time);
+        ++m_events;
+        ++processed;
+
+        // Все участники события получают новую траекторию: сдвигаем их в m_now,
+        // меняем скорость, пересчитываем момент остановки и события
+        auto restart = [&](int k) {
+            BallState& s = m_balls[k];
+            ++s.version;
+            float speed = s.v0.Length();
+            if (speed <= kRestLinearSpeed) {
+                s.v0.SetZero();
+                s.restAt = kNever;
+            } else {
+                s.restAt = (s.damping > 0.f) ? m_now + std::log(speed / kRestLinearSpeed) / s.damping : kNever;
+            }
+        };
+
+        switch (e.type) {
+            case EventType::Rest:
+                moveTo(e.a, m_now);
+                m_balls[e.a].v0.SetZero();
+                restart(e.a);
+                predict(e.a);
+                break;
+
+            case EventType::BallBall:
+                moveTo(e.a, m_now);
+                moveTo(e.b, m_now);
+                resolveBallBall(e.a, e.b);
+                restart(e.a);
+                restart(e.b);
+                predict(e.a);
+                predict(e.b);
+                break;
+
+            case EventType::BallWall:
+                moveTo(e.a, m_now);
+                resolveBallWall(e.a, e.b);
+                restart(e.a);
+                predict(e.a);
+                break;
+
+            case EventType::PocketEnter:
+                // Траектория не меняется — просто сообщаем; шар снимет вызывающий код
+                m_pocketHits.push_back({ m_balls[e.a].body, m_pockets[e.b].index });
+                break;
+        }
+    }
+
+    m_now = std::max(m_now, target);
+    writeBack();
+}
+
+/// Записывает состояние всех движущихся шаров на момент m_now обратно в b2Body.
+void EventSolver::writeBack()
+{
+    for (int i = 0; i < static_cast<int>(m_balls.size()); ++i) {
+        BallState& s = m_balls[i];
+        if (!s.alive) continue;
+
+        bool moving = !isZero(s.v0) || s.w0 != 0.f;
+        bool stale  = !isZero(s.writtenV) || s.writtenW != 0.f;   // последним записали движение
+        if (!moving && !stale) continue;
+
+        moveTo(i, m_now);
+        if (std::abs(s.w0) < kRestAngularSpeed) s.w0 = 0.f;
+
+        s.body->SetTransform(s.p0, s.angle0);
+        s.body->SetLinearVelocity(s.v0);
+        s.body->SetAngularVelocity(s.w0);
+
+        s.writtenP = s.body->GetPosition();
+        s.writtenV = s.v0;
+        s.writtenW = s.w0;
+    }
+}
+
+} // namespace physics
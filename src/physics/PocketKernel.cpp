@@ -0,0 +1,100 @@
+// GLM сам определяет доступные SIMD-расширения по флагам компилятора;
+// пользуемся тем же выбором, что и его собственные *_simd.inl.
+#define GLM_FORCE_INTRINSICS
+#include <glm/simd/platform.h>
+
+#include "physics/PocketKernel.hpp"
+
+#include <algorithm>
+
+namespace physics {
+
+namespace {
+
+    /// Скалярный хвост (и полный fallback): шары [begin, n).
+    void scalarRange(const float* xs, const float* ys, const std::uint8_t* alive,
+                     std::size_t begin, std::size_t n,
+                     const std::vector<Pocket>& pockets, std::uint64_t* out)
+    {
+        for (std::size_t i = begin; i < n; ++i) {
+            if (alive && !alive[i]) continue;
+            for (const auto& p : pockets) {
+                if (inPocket(p, xs[i], ys[i])) {
+                    out[i >> 6] |= std::uint64_t{1} << (i & 63);
+                    break;
+                }
+            }
+        }
+    }
+
+    /// Биты живых слотов из 8 / 4 байт маски alive.
+    inline unsigned aliveBits(const std::uint8_t* alive, std::size_t i, unsigned width)
+    {
+        if (!alive) return (1u << width) - 1u;
+        unsigned bits = 0;
+        for (unsigned k = 0; k < width; ++k) bits |= (alive[i + k] ? 1u : 0u) << k;
+        return bits;
+    }
+
+} // namespace
+
+void pottedMask(const float* xs, const float* ys, const std::uint8_t* alive, std::size_t n,
+                const std::vector<Pocket>& pockets, std::uint64_t* out)
+{
+    std::fill(out, out + (n + 63) / 64, std::uint64_t{0});
+    std::size_t i = 0;
+
+#if GLM_ARCH & GLM_ARCH_AVX2_BIT
+    // 8 шаров за итерацию; 64 кратно 8, поэтому пачка не пересекает границу слова
+    for (; i + 8 <= n; i += 8) {
+        __m256 x   = _mm256_loadu_ps(xs + i);
+        __m256 y   = _mm256_loadu_ps(ys + i);
+        __m256 hit = _mm256_setzero_ps();
+        for (const auto& p : pockets) {
+            __m256 dx = _mm256_sub_ps(x, _mm256_set1_ps(p.center.x));
+            __m256 dy = _mm256_sub_ps(y, _mm256_set1_ps(p.center.y));
+            __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            hit = _mm256_or_ps(hit, _mm256_cmp_ps(d2, _mm256_set1_ps(p.radius * p.radius), _CMP_LE_OQ));
+        }
+        unsigned bits = static_cast<unsigned>(_mm256_movemask_ps(hit)) & aliveBits(alive, i, 8);
+        out[i >> 6] |= std::uint64_t{bits} << (i & 63);
+    }
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+    // 4 шара за итерацию
+    for (; i + 4 <= n; i += 4) {
+        __m128 x   = _mm_loadu_ps(xs + i);
+        __m128 y   = _mm_loadu_ps(ys + i);
+        __m128 hit = _mm_setzero_ps();
+        for (const auto& p : pockets) {
+            __m128 dx = _mm_sub_ps(x, _mm_set1_ps(p.center.x));
+            __m128 dy = _mm_sub_ps(y, _mm_set1_ps(p.center.y));
+            __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+            hit = _mm_or_ps(hit, _mm_cmple_ps(d2, _mm_set1_ps(p.radius * p.radius)));
+        }
+        unsigned bits = static_cast<unsigned>(_mm_movemask_ps(hit)) & aliveBits(alive, i, 4);
+        out[i >> 6] |= std::uint64_t{bits} << (i & 63);
+    }
+#endif
+
+    scalarRange(xs, ys, alive, i, n, pockets, out);
+}
+
+void pottedMask(const BallStore& balls, const std::vector<Pocket>& pockets,
+                std::vector<std::uint64_t>& out)
+{
+    out.resize((balls.size() + 63) / 64);
+    pottedMask(balls.x.data(), balls.y.data(), balls.alive.data(), balls.size(), pockets, out.data());
+}
+
+const char* pocketKernelIsa()
+{
+#if GLM_ARCH & GLM_ARCH_AVX2_BIT
+    return "avx2";
+#elif GLM_ARCH & GLM_ARCH_SSE2_BIT
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+} // namespace physics
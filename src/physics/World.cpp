@@ -1 +1,356 @@
-#include "physics/World.hpp"
\ No newline at end of file
+#include "physics/World.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+
+namespace physics {
+
+    World::World(Backend backend)
+        : m_world(b2Vec2(0.0f, 0.0f))
+        , m_backend(backend)
+    {
+        if (m_backend == Backend::Analytic)
+            m_solver = std::make_unique<EventSolver>(m_world);
+        m_world.SetContactListener(&m_contacts);
+    }
+
+    World::~World() = default;
+
+    void World::step(float dt)
+    {
+        // Все шары спят — ни шага Box2D, ни прохода по шарам. Разбудить стол может
+        // только внешнее изменение (applyImpulse, restore), оно и пересчитает счётчик.
+        if (m_awakeCount == 0) return;
+
+        if (m_solver) {
+            // Событийный решатель сам прыгает от события к событию внутри dt;
+            // входы в карманы он находит как ещё один тип событий
+            m_solver->advance(dt);
+            for (const auto& hit : m_solver->pocketHits())
+                reportPocket(static_cast<int>(hit.body->GetUserData().pointer) - 1, hit.pocket);
+            m_solver->clearPocketHits();
+        } else {
+            // velocityIterations = 8, positionIterations = 3 (типичные значения)
+            m_world.Step(dt, 8, 3);
+            checkPockets();
+        }
+        syncBalls();
+        updateRestState();
+    }
+
+    // ─── Реестр шаров ────────────────────────────────────────────────
+
+    int World::addBall(b2Body* body, float radiusM)
+    {
+        int slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = static_cast<int>(m_bodies.size());
+            m_bodies.push_back(nullptr);
+            m_generations.push_back(0);
+            m_balls.resize(m_bodies.size());
+        }
+
+        m_bodies[slot]      = body;
+        body->GetUserData().pointer = static_cast<uintptr_t>(slot) + 1;   // для слушателя контактов
+        m_balls.r[slot]     = radiusM;
+        m_balls.alive[slot] = 1;
+        syncSlot(slot);
+        updateRestState();
+        return slot;
+    }
+
+    void World::removeBall(int slot)
+    {
+        // DestroyBody сам вызовет EndContact для касаний сенсоров
+        if (b2Body* b = m_bodies[slot]) m_world.DestroyBody(b);
+        m_bodies[slot]      = nullptr;
+        ++m_generations[slot];            // старые handle'ы на этот слот больше не разрешаются
+        m_balls.alive[slot] = 0;
+        setAwakeFlag(slot, 0);
+        m_balls.vx[slot] = m_balls.vy[slot] = m_balls.w[slot] = 0.f;
+        m_freeSlots.push_back(slot);
+        updateRestState();
+    }
+
+    void World::pot(int slot)
+    {
+        // Выключенное тело выпадает из broad-phase и контактов (EndContact придёт сам),
+        // событийный решатель тоже перестаёт его видеть
+        m_bodies[slot]->SetEnabled(false);
+        m_balls.alive[slot] = 0;
+        setAwakeFlag(slot, 0);
+        m_balls.vx[slot] = m_balls.vy[slot] = m_balls.w[slot] = 0.f;
+        updateRestState();
+    }
+
+    void World::syncSlot(int slot)
+    {
+        const b2Body* b = m_bodies[slot];
+        const b2Vec2& p = b->GetPosition();
+        const b2Vec2& v = b->GetLinearVelocity();
+        m_balls.x[slot]     = p.x;
+        m_balls.y[slot]     = p.y;
+        m_balls.vx[slot]    = v.x;
+        m_balls.vy[slot]    = v.y;
+        m_balls.w[slot]     = b->GetAngularVelocity();
+        setAwakeFlag(slot, b->IsAwake() ? 1 : 0);
+    }
+
+    void World::setAwakeFlag(int slot, std::uint8_t awake)
+    {
+        m_awakeCount += static_cast<int>(awake) - static_cast<int>(m_balls.awake[slot]);
+        m_balls.awake[slot] = awake;
+    }
+
+    void World::updateRestState()
+    {
+        const bool rest = m_awakeCount == 0;
+        if (rest && !m_idle && m_onRest) {
+            m_idle = true;      // до вызова: колбэк может сразу ударить
+            m_onRest();
+            return;
+        }
+        m_idle = rest;
+    }
+
+    /// Единственное за шаг место, где мы ходим по b2Body* всех шаров.
+    void World::syncBalls()
+    {
+        const int n = static_cast<int>(m_bodies.size());
+        for (int i = 0; i < n; ++i)
+            if (m_bodies[i] && m_balls.alive[i]) syncSlot(i);
+    }
+
+    // ─── Изменения снаружи шага ──────────────────────────────────────
+
+    void World::applyImpulse(int slot, const b2Vec2& impulse)
+    {
+        m_bodies[slot]->ApplyLinearImpulseToCenter(impulse, true);
+        syncSlot(slot);
+        updateRestState();
+    }
+
+    void World::teleport(int slot, const b2Vec2& posM)
+    {
+        b2Body* b = m_bodies[slot];
+        b->SetTransform(posM, 0.f);
+        b->SetLinearVelocity({0, 0});
+        syncSlot(slot);
+        updateRestState();
+    }
+
+    void World::settle(float vEps, float wEps)
+    {
+        if (m_awakeCount == 0) return;   // спящие тела уже с нулевыми скоростями
+        const float vEps2 = vEps * vEps;
+        const std::size_t n = m_balls.size();
+        m_settleMask.resize(n);
+
+        // 1) Пороговый проход по плотным массивам — без ветвлений, векторизуется.
+        //    Бит 0: погасить линейную скорость, бит 1: угловую, бит 2: усыпить тело.
+        const float* vx = m_balls.vx.data();
+        const float* vy = m_balls.vy.data();
+        const float* w  = m_balls.w.data();
+        const std::uint8_t* alive = m_balls.alive.data();
+        const std::uint8_t* awake = m_balls.awake.data();
+        std::uint8_t* mask = m_settleMask.data();
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint8_t slowLin = (vx[i] * vx[i] + vy[i] * vy[i]) < vEps2;
+            std::uint8_t slowAng = std::fabs(w[i]) < wEps;
+            std::uint8_t linNZ   = (vx[i] != 0.f) | (vy[i] != 0.f);
+            std::uint8_t angNZ   = w[i] != 0.f;
+            std::uint8_t live    = static_cast<std::uint8_t>(-(alive[i] & awake[i]));   // 0x00 / 0xFF
+            mask[i] = live & ((slowLin & linNZ) | ((slowAng & angNZ) << 1) | ((slowLin & slowAng) << 2));
+        }
+
+        // 2) Точечные записи только в те тела, которым это действительно нужно
+        for (std::size_t i = 0; i < n; ++i) {
+            if (!mask[i]) continue;
+            b2Body* b = m_bodies[i];
+            if (mask[i] & 1) { b->SetLinearVelocity({0, 0}); m_balls.vx[i] = m_balls.vy[i] = 0.f; }
+            if (mask[i] & 2) { b->SetAngularVelocity(0);     m_balls.w[i] = 0.f; }
+            if (mask[i] & 4) { b->SetAwake(false);           setAwakeFlag(static_cast<int>(i), 0); }
+        }
+        updateRestState();
+    }
+
+    bool World::atRest(float vEps, float wEps) const
+    {
+        if (m_awakeCount == 0) return true;
+        const float vEps2 = vEps * vEps;
+        const std::size_t n = m_balls.size();
+        std::uint8_t moving = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint8_t fast = ((m_balls.vx[i] * m_balls.vx[i] + m_balls.vy[i] * m_balls.vy[i]) > vEps2) |
+                                (std::fabs(m_balls.w[i]) > wEps);
+            moving |= m_balls.alive[i] & fast;
+        }
+        return !moving;
+    }
+
+    float World::maxSpeed() const
+    {
+        if (m_awakeCount == 0) return 0.f;
+        const std::size_t n = m_balls.size();
+        float v2 = 0.f;
+        for (std::size_t i = 0; i < n; ++i) {
+            float s2 = m_balls.vx[i] * m_balls.vx[i] + m_balls.vy[i] * m_balls.vy[i];
+            v2 = std::max(v2, m_balls.alive[i] ? s2 : 0.f);
+        }
+        return std::sqrt(v2);
+    }
+
+    // ─── Снимки состояния ────────────────────────────────────────────
+
+    void World::snapshot(WorldSnapshot& out) const
+    {
+        const std::size_t n = m_balls.size();
+        out.balls.resize(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            BallSnapshot& s = out.balls[i];
+            s.x     = m_balls.x[i];
+            s.y     = m_balls.y[i];
+            s.angle = m_bodies[i] ? m_bodies[i]->GetAngle() : 0.f;
+            s.vx    = m_balls.vx[i];
+            s.vy    = m_balls.vy[i];
+            s.w     = m_balls.w[i];
+            s.alive = m_balls.alive[i];
+            s.awake = m_balls.awake[i];
+        }
+    }
+
+    WorldSnapshot World::snapshot() const
+    {
+        WorldSnapshot out;
+        snapshot(out);
+        return out;
+    }
+
+    void World::restore(const WorldSnapshot& snap)
+    {
+        const std::size_t n = std::min(snap.balls.size(), m_balls.size());
+        for (std::size_t i = 0; i < n; ++i) {
+            b2Body* b = m_bodies[i];
+            if (!b) continue;
+            const BallSnapshot& s = snap.balls[i];
+
+            // Сначала позиция: при включении тело попадёт в broad-phase уже на своём месте
+            b->SetTransform({ s.x, s.y }, s.angle);
+            if (b->IsEnabled() != static_cast<bool>(s.alive))
+                b->SetEnabled(s.alive != 0);
+
+            if (s.alive && s.awake) {
+                b->SetAwake(true);
+                b->SetLinearVelocity({ s.vx, s.vy });
+                b->SetAngularVelocity(s.w);
+            } else {
+                b->SetAwake(false);   // обнуляет скорости
+            }
+
+            m_balls.x[i]     = s.x;
+            m_balls.y[i]     = s.y;
+            m_balls.vx[i]    = s.alive && s.awake ? s.vx : 0.f;
+            m_balls.vy[i]    = s.alive && s.awake ? s.vy : 0.f;
+            m_balls.w[i]     = s.alive && s.awake ? s.w  : 0.f;
+            m_balls.alive[i] = s.alive;
+            setAwakeFlag(static_cast<int>(i), s.alive & s.awake);
+        }
+
+        // Попадания, найденные после снимка, к восстановленному столу не относятся
+        m_pocketEvents.clear();
+        updateRestState();
+    }
+
+    // ─── Хеш состояния ───────────────────────────────────────────────
+
+    void World::mixStateHash()
+    {
+        // FNV-1a по 32-битным словам: xor и умножение на нечётное — биекция,
+        // так что отличие в любом одном слове не может сократиться дальше
+        constexpr std::uint64_t kPrime = 0x100000001b3ull;
+        std::uint64_t h = m_stateHash;
+        auto mix = [&h](const std::vector<float>& v) {
+            for (float f : v) h = (h ^ std::bit_cast<std::uint32_t>(f)) * kPrime;
+        };
+        mix(m_balls.x);  mix(m_balls.y);
+        mix(m_balls.vx); mix(m_balls.vy);
+        mix(m_balls.w);
+        for (std::uint8_t a : m_balls.alive) h = (h ^ a) * kPrime;
+        m_stateHash = h;
+    }
+
+    // ─── Карманы ─────────────────────────────────────────────────────
+
+    void World::addPockets(b2Body* table, const std::vector<Pocket>& pockets)
+    {
+        m_pockets = pockets;
+        for (std::size_t k = 0; k < pockets.size(); ++k) {
+            b2CircleShape circle;
+            circle.m_p.Set(pockets[k].center.x, pockets[k].center.y);
+            circle.m_radius = pockets[k].radius;
+
+            b2FixtureDef fd;
+            fd.shape    = &circle;
+            fd.isSensor = true;
+            fd.userData.pointer = static_cast<uintptr_t>(k) + 1;   // номер кармана + 1
+            table->CreateFixture(&fd);
+        }
+    }
+
+    namespace {
+        /// Разбирает контакт «сенсор кармана — шар» в (слот, карман); false для прочих контактов.
+        bool pocketContact(b2Contact* contact, std::pair<int, int>& out)
+        {
+            b2Fixture* a = contact->GetFixtureA();
+            b2Fixture* b = contact->GetFixtureB();
+            if (b->IsSensor()) std::swap(a, b);
+            if (!a->IsSensor() || b->IsSensor()) return false;
+
+            uintptr_t pocket = a->GetUserData().pointer;
+            uintptr_t slot   = b->GetBody()->GetUserData().pointer;
+            if (pocket == 0 || slot == 0) return false;
+
+            out = { static_cast<int>(slot) - 1, static_cast<int>(pocket) - 1 };
+            return true;
+        }
+    }
+
+    void World::PocketContacts::BeginContact(b2Contact* contact)
+    {
+        std::pair<int, int> p;
+        if (pocketContact(contact, p)) near.push_back(p);
+    }
+
+    void World::PocketContacts::EndContact(b2Contact* contact)
+    {
+        std::pair<int, int> p;
+        if (!pocketContact(contact, p)) return;
+        auto it = std::find(near.begin(), near.end(), p);
+        if (it != near.end()) {
+            *it = near.back();
+            near.pop_back();
+        }
+    }
+
+    /// Точная проверка после подшага — только для шаров, касающихся сенсоров.
+    void World::checkPockets()
+    {
+        for (const auto& [slot, pocket] : m_contacts.near) {
+            const b2Vec2& c = m_bodies[slot]->GetPosition();
+            if (inPocket(m_pockets[pocket], c.x, c.y))
+                reportPocket(slot, pocket);
+        }
+    }
+
+    void World::reportPocket(int slot, int pocket)
+    {
+        for (const auto& e : m_pocketEvents)
+            if (e.slot == slot) return;
+        m_pocketEvents.push_back({ slot, pocket });
+    }
+
+} // namespace physics
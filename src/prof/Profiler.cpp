@@ -0,0 +1,139 @@
+#include "prof/Profiler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace prof {
+
+Profiler& Profiler::instance()
+{
+    static Profiler p;
+    return p;
+}
+
+Profiler::Profiler()
+    : m_epoch(Clock::now())
+{}
+
+Profiler::~Profiler()
+{
+    // Chrome принимает и незакрытый массив, но аккуратнее закрыть
+    if (m_trace.is_open()) m_trace << "\n]\n";
+}
+
+bool Profiler::openCsv(const std::string& path)
+{
+    m_csv.open(path, std::ios::trunc);
+    if (!m_csv) return false;
+    m_csv << "frame,zone,thread,begin_us,ms\n";
+    setEnabled(true);
+    return true;
+}
+
+bool Profiler::openChromeTrace(const std::string& path)
+{
+    m_trace.open(path, std::ios::trunc);
+    if (!m_trace) return false;
+    m_trace << "[";
+    m_traceEmpty = true;
+    setEnabled(true);
+    return true;
+}
+
+std::uint32_t Profiler::threadIndex()
+{
+    // Маленькие номера потоков читаются в trace лучше, чем хэши std::thread::id
+    static std::atomic<std::uint32_t> next{ 0 };
+    thread_local const std::uint32_t index = next.fetch_add(1, std::memory_order_relaxed);
+    return index;
+}
+
+void Profiler::record(const char* name, Clock::time_point begin, Clock::time_point end)
+{
+    if (!enabled()) return;
+    Event e{ name, threadIndex(),
+             std::chrono::duration_cast<std::chrono::microseconds>(begin - m_epoch).count(),
+             std::chrono::duration<double, std::milli>(end - begin).count(), false };
+    std::lock_guard lock(m_mutex);
+    m_events.push_back(e);
+}
+
+void Profiler::recordValue(const char* name, double ms)
+{
+    if (!enabled()) return;
+    Event e{ name, threadIndex(),
+             std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - m_epoch).count(),
+             ms, true };
+    std::lock_guard lock(m_mutex);
+    m_events.push_back(e);
+}
+
+Profiler::Rolling& Profiler::zone(const char* name)
+{
+    // Зон десяток — линейный поиск; сначала по указателю, потом по тексту
+    for (Rolling& z : m_zones)
+        if (z.name == name) return z;
+    for (Rolling& z : m_zones)
+        if (std::strcmp(z.name, name) == 0) return z;
+    m_zones.push_back({ name });
+    return m_zones.back();
+}
+
+void Profiler::endFrame()
+{
+    if (!enabled()) return;
+    {
+        std::lock_guard lock(m_mutex);
+        m_closing.swap(m_events);
+    }
+
+    // 1) Суммы кадра по зонам → скользящее окно (зоны без событий получают 0)
+    m_frameSum.assign(m_zones.size(), 0.f);
+    for (const Event& e : m_closing) {
+        Rolling& z = zone(e.name);
+        const std::size_t i = static_cast<std::size_t>(&z - m_zones.data());
+        if (i >= m_frameSum.size()) m_frameSum.resize(i + 1, 0.f);
+        m_frameSum[i] += static_cast<float>(e.ms);
+    }
+    const std::size_t slot = m_frame % kWindow;
+    for (std::size_t i = 0; i < m_zones.size(); ++i) {
+        m_zones[i].ms[slot] = m_frameSum[i];
+        m_zones[i].last     = m_frameSum[i];
+    }
+
+    // 2) Выгрузка
+    for (const Event& e : m_closing) {
+        if (m_csv.is_open())
+            m_csv << m_frame << ',' << e.name << ',' << e.thread << ',' << e.beginUs << ',' << e.ms << '\n';
+        if (m_trace.is_open()) {
+            m_trace << (m_traceEmpty ? "\n" : ",\n");
+            m_traceEmpty = false;
+            if (e.value)   // счётчик: отдельный график в trace viewer
+                m_trace << R"({"name":")" << e.name << R"(","ph":"C","pid":1,"ts":)" << e.beginUs
+                        << R"(,"args":{"ms":)" << e.ms << "}}";
+            else
+                m_trace << R"({"name":")" << e.name << R"(","ph":"X","pid":1,"tid":)" << e.thread
+                        << R"(,"ts":)" << e.beginUs << R"(,"dur":)" << static_cast<std::int64_t>(e.ms * 1000.0) << "}";
+        }
+    }
+    m_closing.clear();
+    ++m_frame;
+}
+
+std::vector<ZoneStats> Profiler::stats() const
+{
+    const std::size_t filled = std::min<std::uint64_t>(m_frame, kWindow);
+    std::vector<ZoneStats> out;
+    out.reserve(m_zones.size());
+    for (const Rolling& z : m_zones) {
+        float sum = 0.f, peak = 0.f;
+        for (std::size_t i = 0; i < filled; ++i) {
+            sum += z.ms[i];
+            peak = std::max(peak, z.ms[i]);
+        }
+        out.push_back({ z.name, z.last, filled ? sum / float(filled) : 0.f, peak });
+    }
+    return out;
+}
+
+} // namespace prof
@@ -1,63 +1,44 @@
 #include "render/GLRenderer.hpp"
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
 #include <iostream>
 #include <glm/gtc/matrix_transform.hpp>
+#include "render/MeshBuilder.hpp"
+#include "render/MeshOptimizer.hpp"
+#include "Utils/Scale.hpp"
 
 using namespace render;
 
 namespace {
-    // Вспомогательная функция чтения текстового файла в std::string
-    static std::string readFile(const std::string& path) {
-        std::ifstream file(path);
-        if (!file.is_open()) {
-            std::cerr << "Failed to open file: " << path << "\n";
-            return {};
-        }
-        std::stringstream ss;
-        ss << file.rdbuf();
-        return ss.str();
-    }
+    const float kFovY = glm::radians(45.0f);
+    /// Желаемая длина ребра по экватору сферы, px. Уровень выбирается самый грубый,
+    /// у которого ребро не длиннее — мельче уже не видно, крупнее видна гранёность.
+    constexpr float kLodEdgePx = 5.0f;
+    /// Сдвиг за один шаг физики, после которого шар не интерполируется, а
+    /// переставляется (возврат битка из лузы). Реальные скорости дают на порядок меньше.
+    constexpr float kMaxLerpJumpM = 1.0f;
 }
 
-bool GLRenderer::init(const std::string& shaderDir)
+bool GLRenderer::init(const std::string& shaderDir, const std::string& cacheDir)
 {
-    // 1) Читаем и компилируем вершинный шейдер
-    std::string vertCode = readFile(shaderDir + "/phong.vert");
-    if (vertCode.empty()) return false;
-    unsigned int vs = compileShader(vertCode.c_str(), GL_VERTEX_SHADER);
-    if (vs == 0) {
-        std::cerr << "Vertex shader compilation failed\n";
-        return false;
-    }
-
-    // 2) Читаем и компилируем фрагментный шейдер
-    std::string fragCode = readFile(shaderDir + "/phong.frag");
-    if (fragCode.empty()) return false;
-    unsigned int fs = compileShader(fragCode.c_str(), GL_FRAGMENT_SHADER);
-    if (fs == 0) {
-        std::cerr << "Fragment shader compilation failed\n";
-        glDeleteShader(vs);
-        return false;
-    }
-
-    // 3) Линкуем программу
-    m_program = linkProgram(vs, fs);
-    // После линковки удаляем шейдеры
-    glDeleteShader(vs);
-    glDeleteShader(fs);
-    if (m_program == 0) {
-        std::cerr << "Shader program linking failed\n";
+    // 1) Шейдеры: компиляция (или бинарник из кэша), линковка и таблица uniform'ов — внутри ShaderProgram
+    m_phong.setBinaryCacheDir(cacheDir);
+    m_impostor.setBinaryCacheDir(cacheDir);
+    if (!m_phong.load(shaderDir + "/phong.vert", shaderDir + "/phong.frag") ||
+        !m_impostor.load(shaderDir + "/impostor.vert", shaderDir + "/impostor.frag")) {
+        std::cerr << "Shader program creation failed\n";
         return false;
     }
 
-    // 4) Создаём меши: сфера и стол
-    // радиус шара: 10 px -> 10/100 = 0.1 m, но вы можете скорректировать
-    createSphereMesh(/*radius*/ 0.1f, /*rings*/16, /*sectors*/32);
+    // 2) Создаём меши: сфера и стол
+    // Сфера единичная — реальный радиус шара приходит из буфера экземпляров
+    createSphereMesh();
+    createQuadMesh();
     createTableMesh(/*wPx*/ 1280.f, /*hPx*/720.f, /*hBorderPx*/ 20.f);
 
-    // 5) Включаем тест глубины
+    // 3) Включаем тест глубины (drawScene всё равно выставляет его заново каждый кадр)
     glEnable(GL_DEPTH_TEST);
 
     return true;
@@ -67,109 +48,21 @@ void GLRenderer::resize(int w, int h)
 {
     if (h == 0) h = 1;
     m_aspect = static_cast<float>(w) / static_cast<float>(h);
+    m_viewportH = h;
 }
 
-unsigned int GLRenderer::compileShader(const char* src, unsigned int type)
-{
-    GLuint shader = glCreateShader(type);
-    glShaderSource(shader, 1, &src, nullptr);
-    glCompileShader(shader);
-
-    // 1) Проверяем status
-    GLint isCompiled = 0;
-    glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
-    if (!isCompiled) {
-        // 2) Узнаём длину лога
-        GLint maxLength = 0;
-        glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
-
-        // 3) Если лог есть — выделяем вектор нужного размера
-        if (maxLength > 1) {
-            std::vector<char> errorLog(maxLength);
-            glGetShaderInfoLog(shader, maxLength, &maxLength, errorLog.data());
-            const char* shaderType = (type == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
-            std::cerr << "Error: " << shaderType << " shader compilation failed:\n"
-                      << std::string(errorLog.data(), maxLength) << "\n";
-        } else {
-            // Если даже INFO_LOG пустой (maxLength ≤ 1)
-            const char* shaderType = (type == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
-            std::cerr << "Error: " << shaderType
-                      << " shader failed to compile, but INFO_LOG is empty\n";
-        }
-        glDeleteShader(shader);
-        return 0;
-    }
-    return shader;
-}
-
-unsigned int GLRenderer::linkProgram(unsigned int vs, unsigned int fs)
-{
-    unsigned int program = glCreateProgram();
-    glAttachShader(program, vs);
-    glAttachShader(program, fs);
-    glLinkProgram(program);
-
-    // Проверяем статус линковки
-    int success;
-    glGetProgramiv(program, GL_LINK_STATUS, &success);
-    if (!success) {
-        char infoLog[512];
-        glGetProgramInfoLog(program, 512, nullptr, infoLog);
-        std::cerr << "Error: Shader program linking failed:\n" << infoLog << "\n";
-        glDeleteProgram(program);
-        return 0;
-    }
-    return program;
-}
-
-/// Генерация UV-сферы: создаём вершины и индексы, записываем в VBO/IBO.
-void GLRenderer::createSphereMesh(float radius, int rings, int sectors)
+/// Генерация UV-сфер всех уровней (buildSphereMesh): вершины и индексы подряд в одни VBO/IBO.
+/// Вершина упакована в 12 байт (SphereVertex), треугольники каждого уровня
+/// переставлены под кэш вершин; ACMR до/после печатается в консоль.
+void GLRenderer::createSphereMesh()
 {
-    std::vector<float> vertices;
-    std::vector<unsigned int> indices;
-    const float PI = 3.14159265358979323846f;
-
-    for (int r = 0; r <= rings; ++r) {
-        float theta = PI * r / rings;
-        float sinTheta = std::sin(theta);
-        float cosTheta = std::cos(theta);
-
-        for (int s = 0; s <= sectors; ++s) {
-            float phi = 2.0f * PI * s / sectors;
-            float sinPhi = std::sin(phi);
-            float cosPhi = std::cos(phi);
-
-            // Позиция
-            float x = cosPhi * sinTheta;
-            float y = cosTheta;
-            float z = sinPhi * sinTheta;
-
-            vertices.push_back(x * radius);
-            vertices.push_back(y * radius);
-            vertices.push_back(z * radius);
-
-            // Нормаль (просто нормализованная)
-            vertices.push_back(x);
-            vertices.push_back(y);
-            vertices.push_back(z);
-        }
-    }
-
-    for (int r = 0; r < rings; ++r) {
-        for (int s = 0; s < sectors; ++s) {
-            int first  = (r * (sectors + 1)) + s;
-            int second = first + sectors + 1;
-            indices.push_back(first);
-            indices.push_back(second);
-            indices.push_back(first + 1);
-
-            indices.push_back(second);
-            indices.push_back(second + 1);
-            indices.push_back(first + 1);
-        }
-    }
-
-    m_indexCount = static_cast<int>(indices.size());
+    std::vector<SphereVertex> vertices;
+    std::vector<std::uint32_t> indices;
+    buildSphereMesh(m_lods, vertices, indices);
+    for (const SphereLod& lod : m_lods)
+        std::cout << "Sphere LOD " << lod.rings << "x" << lod.sectors << ": "
+                  << lod.indexCount / 3 << " tris, ACMR " << lod.acmrBefore << " -> " << lod.acmrAfter
+                  << " (FIFO " << kVertexCacheSize << ")\n";
 
     // Создаём VAO
     glGenVertexArrays(1, &m_vaoSphere);
@@ -178,102 +71,79 @@ void GLRenderer::createSphereMesh(float radius, int rings, int sectors)
     // VBO
     glGenBuffers(1, &m_vboSphere);
     glBindBuffer(GL_ARRAY_BUFFER, m_vboSphere);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float),
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(SphereVertex),
                  vertices.data(), GL_STATIC_DRAW);
 
-    // IBO
+    // IBO: 16-битные индексы, пока все уровни помещаются в 65536 вершин
     glGenBuffers(1, &m_iboSphere);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_iboSphere);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int),
-                 indices.data(), GL_STATIC_DRAW);
+    if (vertices.size() <= 0x10000) {
+        std::vector<std::uint16_t> narrow(indices.begin(), indices.end());
+        m_indexType = GL_UNSIGNED_SHORT;
+        m_indexSize = sizeof(std::uint16_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, narrow.size() * sizeof(std::uint16_t),
+                     narrow.data(), GL_STATIC_DRAW);
+    } else {
+        m_indexType = GL_UNSIGNED_INT;
+        m_indexSize = sizeof(std::uint32_t);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint32_t),
+                     indices.data(), GL_STATIC_DRAW);
+    }
 
-    // Позиция: layout(location = 0) в шейдере
+    // Позиция: layout(location = 0) в шейдере — snorm16 ×3, pad не читается
     glEnableVertexAttribArray(0);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE,
-                          6 * sizeof(float), (void*)0);
+    glVertexAttribPointer(0, 3, GL_SHORT, GL_TRUE,
+                          sizeof(SphereVertex), (void*)offsetof(SphereVertex, px));
 
-    // Нормаль: layout(location = 1) в шейдере
+    // Нормаль: layout(location = 1) в шейдере — snorm 10:10:10:2
     glEnableVertexAttribArray(1);
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE,
-                          6 * sizeof(float), (void*)(3 * sizeof(float)));
+    glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE,
+                          sizeof(SphereVertex), (void*)offsetof(SphereVertex, normal));
+
+    // Экземпляры: layout(location = 2) — vec4(центр, радиус), шаг 1 на экземпляр.
+    // Сам буфер заполняется каждый кадр в uploadInstances.
+    glGenBuffers(1, &m_vboInstances);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vboInstances);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+    glVertexAttribDivisor(2, 1);
 
     // Unbind
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindVertexArray(0);
 }
 
-/// Создаём VBO для плоскости стола (две треугольных плоскости) и борта (четыре прямоугольника).
-void GLRenderer::createTableMesh(float wPx, float hPx, float hBorderPx)
+/// Квадрат-импостор: четыре угла полосой треугольников, остальное — в вершинном шейдере.
+void GLRenderer::createQuadMesh()
 {
-    // Конвертируем размеры из пикселей в метры (100 px = 1 m)
-    const float PPM = 100.f;
-    auto toM = [&](float px) { return px / PPM; };
+    const float corners[] = { -1.f, -1.f,   1.f, -1.f,   -1.f, 1.f,   1.f, 1.f };
 
-    float halfW = toM(wPx) / 2.0f;
-    float halfH = toM(hPx) / 2.0f;
-    float borderHeight = toM(hBorderPx);
+    glGenVertexArrays(1, &m_vaoQuad);
+    glBindVertexArray(m_vaoQuad);
 
-    // Сначала строим «плоскость» стола (четыре вершины)
-    //  (x,y,z) → здесь z=0, y=0 (плоскость XZ)
-    std::vector<float> data;
+    glGenBuffers(1, &m_vboQuad);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vboQuad);
+    glBufferData(GL_ARRAY_BUFFER, sizeof corners, corners, GL_STATIC_DRAW);
+
+    // Угол: layout(location = 0)
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), (void*)0);
+
+    // Экземпляры: тот же буфер, что и у сфер (создан в createSphereMesh)
+    glBindBuffer(GL_ARRAY_BUFFER, m_vboInstances);
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4), (void*)0);
+    glVertexAttribDivisor(2, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindVertexArray(0);
+}
 
-    // 6 координат (x, y, z) на каждый из шести треугольников (2 треугольника для плоскости, 
-    // 4 треугольника для каждого борта). В данном примере мы упрощаем:
-    // 1) Стол: две треугольных плоскости (по XZ, y=0):
-    data.insert(data.end(), {
-        -halfW, 0.0f, -halfH,
-         halfW, 0.0f, -halfH,
-        -halfW, 0.0f,  halfH,
-
-         halfW, 0.0f, -halfH,
-         halfW, 0.0f,  halfH,
-        -halfW, 0.0f,  halfH
-    });
-
-    // 2) Борта (высота) — четыре боковых прямоугольника:
-    // Левый борт (x = -halfW):
-    data.insert(data.end(), {
-        -halfW, 0.0f, -halfH,
-        -halfW, borderHeight, -halfH,
-        -halfW, 0.0f,  halfH,
-
-        -halfW, borderHeight, -halfH,
-        -halfW, borderHeight,  halfH,
-        -halfW, 0.0f,  halfH
-    });
-
-    // Правый борт (x = +halfW)
-    data.insert(data.end(), {
-         halfW, 0.0f, -halfH,
-         halfW, 0.0f,  halfH,
-         halfW, borderHeight, -halfH,
-
-         halfW, borderHeight, -halfH,
-         halfW, 0.0f,  halfH,
-         halfW, borderHeight,  halfH
-    });
-
-    // Передний борт (z = +halfH)
-    data.insert(data.end(), {
-        -halfW, 0.0f,  halfH,
-         halfW, 0.0f,  halfH,
-        -halfW, borderHeight,  halfH,
-
-         halfW,  borderHeight,  halfH,
-         halfW,  0.0f,  halfH,
-        -halfW,  borderHeight,  halfH
-    });
-
-    // Задний борт (z = -halfH)
-    data.insert(data.end(), {
-        -halfW, 0.0f, -halfH,
-        -halfW, borderHeight, -halfH,
-         halfW, 0.0f, -halfH,
-
-        -halfW, borderHeight, -halfH,
-         halfW,  borderHeight, -halfH,
-         halfW,  0.0f, -halfH
-    });
+/// Создаём VBO для плоскости стола и бортов (геометрия — buildTableMesh).
+void GLRenderer::createTableMesh(float wPx, float hPx, float hBorderPx)
+{
+    std::vector<float> data;
+    buildTableMesh(wPx, hPx, hBorderPx, data);
 
     // Создаём VAO для стола
     glGenVertexArrays(1, &m_vaoTable);
@@ -296,20 +166,103 @@ void GLRenderer::createTableMesh(float wPx, float hPx, float hBorderPx)
     glBindVertexArray(0);
 }
 
-void GLRenderer::drawScene(const std::vector<physics::Ball>&    balls,
+int GLRenderer::pickLod(float radius, float distance) const
+{
+    // Экранный радиус: r · (H/2) / (tg(fov/2) · d). Камера внутри шара — максимум.
+    if (distance <= radius) return kLodCount - 1;
+    const float radiusPx = radius * 0.5f * static_cast<float>(m_viewportH)
+                         / (std::tan(kFovY * 0.5f) * distance);
+    const float circumferencePx = 2.0f * 3.14159265f * radiusPx;
+
+    for (int k = 0; k < kLodCount - 1; ++k)
+        if (m_lods[k].sectors * kLodEdgePx >= circumferencePx) return k;
+    return kLodCount - 1;
+}
+
+int GLRenderer::uploadInstances(const physics::BallStore& prev, const physics::BallStore& curr, float alpha,
+                                float offsetX, float offsetZ, const glm::vec3& eye)
+{
+    // Плоскость стола — XZ; шар стоит на ней, поэтому центр поднят на радиус
+    m_unsorted.clear();
+    m_instanceLod.clear();
+    m_lodCount.fill(0);
+    const std::size_t n = curr.size();
+    const std::size_t nPrev = prev.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!curr.alive[i]) continue;
+        float rM = curr.r[i];
+        float x  = curr.x[i];
+        float y  = curr.y[i];
+        if (i < nPrev && prev.alive[i]) {
+            const float dx = x - prev.x[i];
+            const float dy = y - prev.y[i];
+            if (dx * dx + dy * dy < kMaxLerpJumpM * kMaxLerpJumpM) {
+                x = prev.x[i] + alpha * dx;
+                y = prev.y[i] + alpha * dy;
+            }
+        }
+        glm::vec3 center(x + offsetX, rM, y + offsetZ);
+        int lod = pickLod(rM, glm::length(center - eye));
+        m_unsorted.emplace_back(center, rM);
+        m_instanceLod.push_back(static_cast<std::uint8_t>(lod));
+        ++m_lodCount[lod];
+    }
+
+    // Раскладка подсчётом: экземпляры одного уровня идут подряд
+    int at = 0;
+    for (int k = 0; k < kLodCount; ++k) {
+        m_lodFirst[k] = at;
+        at += m_lodCount[k];
+    }
+    m_instances.resize(m_unsorted.size());
+    std::array<int, kLodCount> next = m_lodFirst;
+    for (std::size_t j = 0; j < m_unsorted.size(); ++j)
+        m_instances[next[m_instanceLod[j]]++] = m_unsorted[j];
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vboInstances);
+    const std::size_t bytes = m_instances.size() * sizeof(glm::vec4);
+    if (m_instances.size() > m_instanceCapacity)   // растём с запасом
+        m_instanceCapacity = std::max<std::size_t>(m_instances.size(), 2 * m_instanceCapacity);
+    // Orphaning: драйвер отдаёт свежее хранилище, не дожидаясь, пока GPU дочитает прошлый кадр
+    glBufferData(GL_ARRAY_BUFFER, m_instanceCapacity * sizeof(glm::vec4), nullptr, GL_STREAM_DRAW);
+    if (bytes) glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_instances.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    return static_cast<int>(m_instances.size());
+}
+
+void GLRenderer::drawScene(const physics::BallStore&           balls,
+                           const std::vector<physics::Pocket>& pockets,
+                           float tableWpx,
+                           float tableHpx)
+{
+    drawScene(balls, balls, 1.0f, pockets, tableWpx, tableHpx);
+}
+
+void GLRenderer::drawScene(const physics::BallStore&           prev,
+                           const physics::BallStore&           curr,
+                           float alpha,
                            const std::vector<physics::Pocket>& pockets,
                            float tableWpx,
                            float tableHpx)
 {
+    // 0) Своё состояние GL — каждый кадр: между кадрами им пользуется SFML (HUD,
+    //    вид сверху), а RenderTarget::resetGLStates() выключает тест глубины и включает
+    //    смешивание. Маска глубины нужна ещё до glClear, иначе буфер не очистится
+    glEnable(GL_DEPTH_TEST);
+    glDepthMask(GL_TRUE);
+    glDisable(GL_BLEND);
+
     // 1) Очищаем цвет и глубину
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
-    // 2) Активируем шейдерную программу
-    glUseProgram(m_program);
+    // 2) Активируем шейдерную программу (после правки файлов — уже пересобранную)
+    m_phong.reloadIfChanged();
+    m_phong.use();
 
     // 3) Вычисляем матрицы view и proj
     glm::mat4 proj = glm::perspective(
-        glm::radians(45.0f),
+        kFovY,
         m_aspect,
         0.1f,
         50.0f
@@ -322,50 +275,63 @@ void GLRenderer::drawScene(const std::vector<physics::Ball>&    balls,
     );
     glm::mat4 view = glm::lookAt(eye, glm::vec3(0,0,0), glm::vec3(0,1,0));
 
-    // 4) Передаём матрицы в шейдер
-    int locView = glGetUniformLocation(m_program, "uView");
-    glUniformMatrix4fv(locView, 1, GL_FALSE, &view[0][0]);
+    // 4) Передаём матрицы в шейдер (неизменившиеся до драйвера не доходят)
+    m_phong.set("uView", view);
+    m_phong.set("uProj", proj);
 
-    int locProj = glGetUniformLocation(m_program, "uProj");
-    glUniformMatrix4fv(locProj, 1, GL_FALSE, &proj[0][0]);
-
-    int locViewPos = glGetUniformLocation(m_program, "uView");
-    glUniform3f(locViewPos, eye.x, eye.y, eye.z);
+    m_drawCalls = 0;
+    m_triangles = 0;
 
     // 5) Рисуем стол + борта
     glBindVertexArray(m_vaoTable);
-    glm::mat4 identity = glm::mat4(1.0f);
 
     // Цвет стола (тёмно-зелёный)
-    int locColor = glGetUniformLocation(m_program, "uColor");
-    glUniform3f(locColor, 0.05f, 0.35f, 0.05f);
+    m_phong.set("uColor", glm::vec3(0.05f, 0.35f, 0.05f));
 
-    // uModel = identity
-    int locModel = glGetUniformLocation(m_program, "uModel");
-    glUniformMatrix4fv(locModel, 1, GL_FALSE, &identity[0][0]);
+    // У стола атрибут экземпляра выключен: центр (0,0,0), масштаб 1 — вершины как есть
+    glVertexAttrib4f(2, 0.f, 0.f, 0.f, 1.f);
 
     // Всего вершин: 6 для плоскости + 6*4 для четырёх бортов = 30
     glDrawArrays(GL_TRIANGLES, 0, 30);
-
-    // 6) Рисуем шары
-    glBindVertexArray(m_vaoSphere);
-    glUniform3f(locColor, 0.9f, 0.9f, 0.9f);  // белые шары
-
-    for (const auto& b : balls) {
-        b2Vec2 posM = b.body()->GetPosition();
-        float   rM  = (b.radius() / 100.f);      // px → m (PPM = 100)
-
-        // Модельная матрица: сначала сдвигаем (x, r, z), потом масштабируем
-        glm::mat4 model = glm::translate(
-            glm::mat4(1.0f),
-            glm::vec3(posM.x, rM, posM.y)
-        ) * glm::scale(
-            glm::mat4(1.0f),
-            glm::vec3(rM, rM, rM)
-        );
-
-        glUniformMatrix4fv(locModel, 1, GL_FALSE, &model[0][0]);
-        glDrawElements(GL_TRIANGLES, m_indexCount, GL_UNSIGNED_INT, 0);
+    ++m_drawCalls;
+    m_triangles += 10;
+
+    // 6) Рисуем шары. Меш стола центрирован, а координаты шаров идут от угла,
+    //    поэтому сдвигаем их на половину стола.
+    const float offX = -px2m(tableWpx) / 2.f;
+    const float offZ = -px2m(tableHpx) / 2.f;
+    const int instances = uploadInstances(prev, curr, std::clamp(alpha, 0.0f, 1.0f), offX, offZ, eye);
+
+    if (m_ballMode == BallMode::Impostor) {
+        // Все шары — один вызов по 4 вершины; LOD не нужен, силуэт точный
+        m_impostor.reloadIfChanged();
+        m_impostor.use();
+        m_impostor.set("uView", view);
+        m_impostor.set("uProj", proj);
+        m_impostor.set("uColor", glm::vec3(0.9f, 0.9f, 0.9f));  // белые шары
+        glBindVertexArray(m_vaoQuad);
+        if (instances > 0) {
+            glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, instances);
+            ++m_drawCalls;
+            m_triangles += 2L * instances;
+        }
+    } else {
+        // По вызову на каждый непустой уровень детализации
+        glBindVertexArray(m_vaoSphere);
+        m_phong.set("uColor", glm::vec3(0.9f, 0.9f, 0.9f));  // белые шары
+        glBindBuffer(GL_ARRAY_BUFFER, m_vboInstances);
+        for (int k = 0; k < kLodCount; ++k) {
+            if (m_lodCount[k] == 0) continue;
+            const SphereLod& lod = m_lods[k];
+            // Начало группы уровня — через смещение атрибута (base instance в 3.3 нет)
+            glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(glm::vec4),
+                                  (void*)(m_lodFirst[k] * sizeof(glm::vec4)));
+            glDrawElementsInstanced(GL_TRIANGLES, lod.indexCount, m_indexType,
+                                    (void*)(lod.firstIndex * m_indexSize), m_lodCount[k]);
+            ++m_drawCalls;
+            m_triangles += long(lod.indexCount / 3) * m_lodCount[k];
+        }
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
     }
 
     // 7) Привязывать обратно не обязательно, 
@@ -373,4 +339,3 @@ void GLRenderer::drawScene(const std::vector<physics::Ball>&    balls,
     glBindVertexArray(0);
     glUseProgram(0);
 }
-
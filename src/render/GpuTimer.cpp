@@ -0,0 +1,46 @@
+#include "render/GpuTimer.hpp"
+
+using namespace render;
+
+GpuTimer::~GpuTimer()
+{
+    if (m_queries[0]) glDeleteQueries(kQueries, m_queries.data());
+}
+
+void GpuTimer::begin()
+{
+    if (!m_queries[0]) glGenQueries(kQueries, m_queries.data());
+
+    // Слот занят прошлым замером — забираем его, если GPU уже досчитал
+    const int slot = m_next;
+    if (m_pending[slot]) {
+        GLint ready = 0;
+        glGetQueryObjectiv(m_queries[slot], GL_QUERY_RESULT_AVAILABLE, &ready);
+        if (ready) {
+            GLuint64 ns = 0;
+            glGetQueryObjectui64v(m_queries[slot], GL_QUERY_RESULT, &ns);
+            // Некоторые драйверы (llvmpipe) в первом запросе отдают мусор порядка
+            // абсолютной метки времени — такой замер в статистику не пускаем
+            const double ms = static_cast<double>(ns) * 1e-6;
+            if (ms < kMaxPlausibleMs) {
+                m_lastMs  = ms;
+                m_hasLast = true;
+            }
+        }
+        m_pending[slot] = false;    // не готов — замер пропускаем, но не ждём
+    }
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[slot]);
+}
+
+void GpuTimer::end()
+{
+    glEndQuery(GL_TIME_ELAPSED);
+    m_pending[m_next] = true;
+    m_next = (m_next + 1) % kQueries;
+}
+
+bool GpuTimer::latest(double& ms) const
+{
+    if (m_hasLast) ms = m_lastMs;
+    return m_hasLast;
+}
@@ -0,0 +1,147 @@
+#include "render/MeshBuilder.hpp"
+
+#include <cmath>
+#include <glm/glm.hpp>
+#include <glm/gtc/packing.hpp>
+#include "render/MeshOptimizer.hpp"
+
+namespace render {
+
+/// Индексы уже сдвинуты на начало вершин своего уровня — baseVertex не нужен.
+void buildSphereMesh(std::span<SphereLod> lods,
+                     std::vector<SphereVertex>& vertices,
+                     std::vector<std::uint32_t>& indices)
+{
+    std::vector<std::uint32_t> local;
+    const float PI = 3.14159265358979323846f;
+    vertices.clear();
+    indices.clear();
+
+    for (SphereLod& lod : lods) {
+        const int rings   = lod.rings;
+        const int sectors = lod.sectors;
+        const auto base   = static_cast<std::uint32_t>(vertices.size());
+        lod.firstIndex    = static_cast<int>(indices.size());
+
+        for (int r = 0; r <= rings; ++r) {
+            float theta = PI * r / rings;
+            float sinTheta = std::sin(theta);
+            float cosTheta = std::cos(theta);
+
+            for (int s = 0; s <= sectors; ++s) {
+                float phi = 2.0f * PI * s / sectors;
+                float sinPhi = std::sin(phi);
+                float cosPhi = std::cos(phi);
+
+                // Единичная сфера: позиция и нормаль совпадают, обе в [-1, 1]
+                glm::vec3 p(cosPhi * sinTheta, cosTheta, sinPhi * sinTheta);
+
+                SphereVertex v;
+                v.px     = static_cast<std::int16_t>(glm::packSnorm1x16(p.x));
+                v.py     = static_cast<std::int16_t>(glm::packSnorm1x16(p.y));
+                v.pz     = static_cast<std::int16_t>(glm::packSnorm1x16(p.z));
+                v.normal = glm::packSnorm3x10_1x2(glm::vec4(p, 0.0f));
+                vertices.push_back(v);
+            }
+        }
+
+        // Индексы уровня считаем от нуля — так их удобнее переставлять
+        local.clear();
+        for (int r = 0; r < rings; ++r) {
+            for (int s = 0; s < sectors; ++s) {
+                std::uint32_t first  = (r * (sectors + 1)) + s;
+                std::uint32_t second = first + sectors + 1;
+                local.push_back(first);
+                local.push_back(second);
+                local.push_back(first + 1);
+
+                local.push_back(second);
+                local.push_back(second + 1);
+                local.push_back(first + 1);
+            }
+        }
+
+        lod.acmrBefore = acmr(local);
+        optimizeVertexCache(local, std::size_t(rings + 1) * (sectors + 1));
+        lod.acmrAfter  = acmr(local);
+
+        for (std::uint32_t i : local) indices.push_back(base + i);
+        lod.indexCount = static_cast<int>(indices.size()) - lod.firstIndex;
+    }
+}
+
+/// Плоскость стола (две треугольных плоскости) и борта (четыре прямоугольника).
+void buildTableMesh(float wPx, float hPx, float hBorderPx, std::vector<float>& data)
+{
+    // Конвертируем размеры из пикселей в метры (100 px = 1 m)
+    const float PPM = 100.f;
+    auto toM = [&](float px) { return px / PPM; };
+
+    float halfW = toM(wPx) / 2.0f;
+    float halfH = toM(hPx) / 2.0f;
+    float borderHeight = toM(hBorderPx);
+
+    // Сначала строим «плоскость» стола (четыре вершины)
+    //  (x,y,z) → здесь z=0, y=0 (плоскость XZ)
+    data.clear();
+
+    // 6 координат (x, y, z) на каждый из шести треугольников (2 треугольника для плоскости, 
+    // 4 треугольника для каждого борта). В данном примере мы упрощаем:
+    // 1) Стол: две треугольных плоскости (по XZ, y=0):
+    data.insert(data.end(), {
+        -halfW, 0.0f, -halfH,
+         halfW, 0.0f, -halfH,
+        -halfW, 0.0f,  halfH,
+
+         halfW, 0.0f, -halfH,
+         halfW, 0.0f,  halfH,
+        -halfW, 0.0f,  halfH
+    });
+
+    // 2) Борта (высота) — четыре боковых прямоугольника:
+    // Левый борт (x = -halfW):
+    data.insert(data.end(), {
+        -halfW, 0.0f, -halfH,
+        -halfW, borderHeight, -halfH,
+        -halfW, 0.0f,  halfH,
+
+        -halfW, borderHeight, -halfH,
+        -halfW, borderHeight,  halfH,
+        -halfW, 0.0f,  halfH
+    });
+
+    // Правый борт (x = +halfW)
+    data.insert(data.end(), {
+         halfW, 0.0f, -halfH,
+         halfW, 0.0f,  halfH,
+         halfW, borderHeight, -halfH,
+
+         halfW, borderHeight, -halfH,
+         halfW, 0.0f,  halfH,
+         halfW, borderHeight,  halfH
+    });
+
+    // Передний борт (z = +halfH)
+    data.insert(data.end(), {
+        -halfW, 0.0f,  halfH,
+         halfW, 0.0f,  halfH,
+        -halfW, borderHeight,  halfH,
+
+         halfW,  borderHeight,  halfH,
+         halfW,  0.0f,  halfH,
+        -halfW,  borderHeight,  halfH
+    });
+
+    // Задний борт (z = -halfH)
+    data.insert(data.end(), {
+        -halfW, 0.0f, -halfH,
+        -halfW, borderHeight, -halfH,
+         halfW, 0.0f, -halfH,
+
+        -halfW, borderHeight, -halfH,
+         halfW,  borderHeight, -halfH,
+         halfW,  0.0f, -halfH
+    });
+}
+
+} // namespace render
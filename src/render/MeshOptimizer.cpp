@@ -0,0 +1,142 @@
+#include "render/MeshOptimizer.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace render {
+
+namespace {
+    // Кэш моделируем чуть больше целевого: три новые вершины треугольника
+    // временно выталкивают хвост, который ещё может пригодиться.
+    constexpr int kModelCache = static_cast<int>(kVertexCacheSize) + 3;
+
+    /// Оценка вершины: выше у недавно использованных и у почти «доеденных»
+    /// (мало оставшихся треугольников) — их выгодно добрать, пока они в кэше.
+    float vertexScore(int cachePos, int remaining)
+    {
+        if (remaining == 0) return -1.f;
+
+        float score = 0.f;
+        if (cachePos >= 0) {
+            if (cachePos < 3) {
+                score = 0.75f;    // вершины только что выданного треугольника
+            } else {
+                const float scale = 1.f / (static_cast<float>(kVertexCacheSize) - 3.f);
+                score = std::pow(std::max(0.f, 1.f - (cachePos - 3) * scale), 1.5f);
+            }
+        }
+        return score + 2.f / std::sqrt(static_cast<float>(remaining));
+    }
+}
+
+void optimizeVertexCache(std::vector<std::uint32_t>& indices, std::size_t vertexCount)
+{
+    const std::size_t triCount = indices.size() / 3;
+    if (triCount == 0) return;
+
+    // 1) Смежность «вершина → треугольники» в плоском массиве
+    std::vector<int> offset(vertexCount + 1, 0), remaining(vertexCount, 0);
+    for (std::uint32_t v : indices) ++remaining[v];
+    for (std::size_t v = 0; v < vertexCount; ++v) offset[v + 1] = offset[v] + remaining[v];
+    std::vector<int> adjacency(indices.size());
+    {
+        std::vector<int> fill(offset.begin(), offset.end() - 1);
+        for (std::size_t t = 0; t < triCount; ++t)
+            for (int k = 0; k < 3; ++k)
+                adjacency[fill[indices[3 * t + k]]++] = static_cast<int>(t);
+    }
+
+    std::vector<int>   cachePos(vertexCount, -1);
+    std::vector<float> vScore(vertexCount);
+    for (std::size_t v = 0; v < vertexCount; ++v) vScore[v] = vertexScore(-1, remaining[v]);
+
+    std::vector<float> tScore(triCount);
+    std::vector<char>  emitted(triCount, 0);
+    for (std::size_t t = 0; t < triCount; ++t)
+        tScore[t] = vScore[indices[3 * t]] + vScore[indices[3 * t + 1]] + vScore[indices[3 * t + 2]];
+
+    std::vector<std::uint32_t> out;
+    out.reserve(indices.size());
+    std::vector<int> cache, next;
+    cache.reserve(kModelCache + 3);
+    next.reserve(kModelCache + 3);
+
+    int best = 0;
+    std::size_t scan = 0;                 // курсор линейного поиска, когда кэш пуст
+    for (std::size_t emittedCount = 0; emittedCount < triCount; ++emittedCount) {
+        if (best < 0) {
+            while (emitted[scan]) ++scan;  // треугольники ещё есть — найдём
+            best = static_cast<int>(scan);
+            for (std::size_t t = scan; t < triCount; ++t)
+                if (!emitted[t] && tScore[t] > tScore[best]) best = static_cast<int>(t);
+        }
+
+        // 2) Выдаём лучший треугольник и вычёркиваем его из смежности вершин
+        const std::uint32_t* tri = &indices[3 * std::size_t(best)];
+        emitted[best] = 1;
+        next.clear();
+        for (int k = 0; k < 3; ++k) {
+            const std::uint32_t v = tri[k];
+            out.push_back(v);
+            next.push_back(static_cast<int>(v));
+
+            int* first = &adjacency[offset[v]];
+            int* last  = first + remaining[v];
+            std::iter_swap(std::find(first, last, best), last - 1);
+            --remaining[v];
+        }
+
+        // 3) Новый кэш: вершины треугольника впереди, затем старый порядок без повторов
+        for (int v : cache)
+            if (v != int(tri[0]) && v != int(tri[1]) && v != int(tri[2])) next.push_back(v);
+        for (int i = kModelCache; i < int(next.size()); ++i) {
+            cachePos[next[i]] = -1;        // вытолкнуты — оценка станет ниже
+            vScore[next[i]]   = vertexScore(-1, remaining[next[i]]);
+        }
+        if (int(next.size()) > kModelCache) next.resize(kModelCache);
+        cache.swap(next);
+
+        // 4) Пересчёт оценок вершин в кэше и их треугольников; следующий — лучший из них
+        for (int i = 0; i < int(cache.size()); ++i) {
+            cachePos[cache[i]] = i;
+            vScore[cache[i]]   = vertexScore(i, remaining[cache[i]]);
+        }
+        best = -1;
+        float bestScore = -1.f;
+        for (int v : cache) {
+            for (int a = offset[v], e = offset[v] + remaining[v]; a < e; ++a) {
+                const int t = adjacency[a];
+                const std::uint32_t* tv = &indices[3 * std::size_t(t)];
+                tScore[t] = vScore[tv[0]] + vScore[tv[1]] + vScore[tv[2]];
+                if (tScore[t] > bestScore) {
+                    bestScore = tScore[t];
+                    best      = t;
+                }
+            }
+        }
+    }
+
+    indices.swap(out);
+}
+
+float acmr(const std::vector<std::uint32_t>& indices, std::size_t cacheSize)
+{
+    if (indices.size() < 3) return 0.f;
+
+    std::vector<std::uint32_t> fifo;
+    fifo.reserve(cacheSize);
+    std::size_t head = 0, misses = 0;
+    for (std::uint32_t v : indices) {
+        if (std::find(fifo.begin(), fifo.end(), v) != fifo.end()) continue;
+        ++misses;
+        if (fifo.size() < cacheSize) {
+            fifo.push_back(v);
+        } else {
+            fifo[head] = v;                 // FIFO: вытесняем самую старую
+            head = (head + 1) % cacheSize;
+        }
+    }
+    return static_cast<float>(misses) / static_cast<float>(indices.size() / 3);
+}
+
+} // namespace render
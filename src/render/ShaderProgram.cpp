@@ -0,0 +1,376 @@
+#include "render/ShaderProgram.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <vector>
+#include <glm/gtc/type_ptr.hpp>
+#include <SFML/Window.hpp>
+
+using namespace render;
+
+namespace {
+    std::string readFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            std::cerr << "Failed to open file: " << path << "\n";
+            return {};
+        }
+        std::stringstream ss;
+        ss << file.rdbuf();
+        return ss.str();
+    }
+
+    std::filesystem::file_time_type mtime(const std::string& path) {
+        std::error_code ec;
+        auto t = std::filesystem::last_write_time(path, ec);
+        return ec ? std::filesystem::file_time_type{} : t;
+    }
+
+    // glad собран под чистый 3.3 core — функций и констант ARB_get_program_binary
+    // в нём нет, берём их у текущего контекста сами.
+    constexpr GLenum kProgramBinaryRetrievableHint = 0x8257;
+    constexpr GLenum kProgramBinaryLength          = 0x8741;
+    constexpr GLenum kNumProgramBinaryFormats      = 0x87FE;
+
+    struct BinaryApi {
+        void (APIENTRYP getProgramBinary)(GLuint, GLsizei, GLsizei*, GLenum*, void*)   = nullptr;
+        void (APIENTRYP programBinary)(GLuint, GLenum, const void*, GLsizei)           = nullptr;
+        void (APIENTRYP programParameteri)(GLuint, GLenum, GLint)                      = nullptr;
+
+        [[nodiscard]] bool ok() const { return getProgramBinary && programBinary && programParameteri; }
+    };
+
+    /// Точки входа резолвятся один раз на процесс; nullptr'ы, если драйвер не умеет.
+    const BinaryApi& binaryApi()
+    {
+        static const BinaryApi api = [] {
+            BinaryApi a;
+            const bool core41 = GLVersion.major > 4 || (GLVersion.major == 4 && GLVersion.minor >= 1);
+            if (!core41 && !sf::Context::isExtensionAvailable("GL_ARB_get_program_binary")) return a;
+
+            GLint formats = 0;
+            glGetIntegerv(kNumProgramBinaryFormats, &formats);
+            if (formats <= 0) return a;           // расширение есть, но сохранять нечего
+
+            a.getProgramBinary  = reinterpret_cast<decltype(a.getProgramBinary)>(sf::Context::getFunction("glGetProgramBinary"));
+            a.programBinary     = reinterpret_cast<decltype(a.programBinary)>(sf::Context::getFunction("glProgramBinary"));
+            a.programParameteri = reinterpret_cast<decltype(a.programParameteri)>(sf::Context::getFunction("glProgramParameteri"));
+            if (!a.ok()) a = {};
+            return a;
+        }();
+        return api;
+    }
+
+    /// FNV-1a, 64 бит — для имени файла в кэше хватает с запасом.
+    std::uint64_t fnv1a(std::uint64_t h, const void* data, std::size_t n)
+    {
+        const auto* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < n; ++i) {
+            h ^= p[i];
+            h *= 0x100000001b3ull;
+        }
+        return h;
+    }
+
+    std::uint64_t fnv1a(std::uint64_t h, const char* str)
+    {
+        return str ? fnv1a(h, str, std::strlen(str) + 1) : h;   // '\0' тоже в хэш — граница полей
+    }
+
+    /// Заголовок файла кэша; за ним — сам бинарник длиной `length`.
+    struct BinaryHeader {
+        char          magic[4] = { 'B', 'S', 'P', 'B' };
+        std::uint32_t version  = 1;
+        std::uint32_t format   = 0;
+        std::uint32_t length   = 0;
+    };
+
+    /// Компилирует шейдер типа \p type; 0 и лог в std::cerr при ошибке.
+    GLuint compileShader(const char* src, GLenum type)
+    {
+        GLuint shader = glCreateShader(type);
+        glShaderSource(shader, 1, &src, nullptr);
+        glCompileShader(shader);
+
+        GLint isCompiled = 0;
+        glGetShaderiv(shader, GL_COMPILE_STATUS, &isCompiled);
+        if (!isCompiled) {
+            GLint maxLength = 0;
+            glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &maxLength);
+            const char* shaderType = (type == GL_VERTEX_SHADER) ? "VERTEX" : "FRAGMENT";
+            if (maxLength > 1) {
+                std::vector<char> errorLog(maxLength);
+                glGetShaderInfoLog(shader, maxLength, &maxLength, errorLog.data());
+                std::cerr << "Error: " << shaderType << " shader compilation failed:\n"
+                          << std::string(errorLog.data(), maxLength) << "\n";
+            } else {
+                std::cerr << "Error: " << shaderType
+                          << " shader failed to compile, but INFO_LOG is empty\n";
+            }
+            glDeleteShader(shader);
+            return 0;
+        }
+        return shader;
+    }
+}
+
+ShaderProgram::~ShaderProgram()
+{
+    if (m_id) glDeleteProgram(m_id);
+}
+
+bool ShaderProgram::load(const std::string& vertPath, const std::string& fragPath)
+{
+    m_vertPath = vertPath;
+    m_fragPath = fragPath;
+    m_vertTime = mtime(vertPath);
+    m_fragTime = mtime(fragPath);
+    m_lastPoll = std::chrono::steady_clock::now();
+
+    std::string vertCode = readFile(vertPath);
+    std::string fragCode = readFile(fragPath);
+    if (vertCode.empty() || fragCode.empty()) return false;
+
+    const bool cached = !m_cacheDir.empty() && binaryApi().ok();
+    const std::filesystem::path binPath = cached ? cachePath(vertCode, fragCode) : std::filesystem::path{};
+
+    GLuint program = cached ? loadBinary(binPath) : 0;
+    if (program == 0) {
+        program = build(vertCode, fragCode, cached);
+        if (program == 0) return false;
+        if (cached) saveBinary(program, binPath);
+    }
+
+    if (m_id) glDeleteProgram(m_id);
+    m_id = program;
+    reflect();
+    return true;
+}
+
+bool ShaderProgram::reloadIfChanged()
+{
+    if (m_vertPath.empty()) return false;
+
+    // Опрос файловой системы не чаще kPollInterval — в кадре это один вызов now()
+    auto now = std::chrono::steady_clock::now();
+    if (now - m_lastPoll < kPollInterval) return false;
+    m_lastPoll = now;
+
+    auto vt = mtime(m_vertPath);
+    auto ft = mtime(m_fragPath);
+    if (vt == m_vertTime && ft == m_fragTime) return false;
+
+    std::cout << "Reloading shaders: " << m_vertPath << ", " << m_fragPath << "\n";
+    GLuint old = m_id;
+    m_id = 0;                       // load() не должен удалить старую программу до успеха
+    if (!load(m_vertPath, m_fragPath)) {
+        m_id = old;                 // остаёмся на рабочей версии; время уже обновлено,
+        return false;               // повторная попытка — после следующего сохранения
+    }
+    if (old) glDeleteProgram(old);
+    return true;
+}
+
+GLuint ShaderProgram::build(const std::string& vertCode, const std::string& fragCode, bool retrievable) const
+{
+    GLuint vs = compileShader(vertCode.c_str(), GL_VERTEX_SHADER);
+    if (vs == 0) return 0;
+    GLuint fs = compileShader(fragCode.c_str(), GL_FRAGMENT_SHADER);
+    if (fs == 0) {
+        glDeleteShader(vs);
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    glAttachShader(program, vs);
+    glAttachShader(program, fs);
+    if (retrievable)    // подсказка должна стоять до линковки
+        binaryApi().programParameteri(program, kProgramBinaryRetrievableHint, GL_TRUE);
+    glLinkProgram(program);
+    glDeleteShader(vs);
+    glDeleteShader(fs);
+
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        char infoLog[512];
+        glGetProgramInfoLog(program, 512, nullptr, infoLog);
+        std::cerr << "Error: Shader program linking failed:\n" << infoLog << "\n";
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+std::filesystem::path ShaderProgram::cachePath(const std::string& vertCode, const std::string& fragCode) const
+{
+    std::uint64_t h = 0xcbf29ce484222325ull;
+    h = fnv1a(h, vertCode.c_str());
+    h = fnv1a(h, fragCode.c_str());
+    // Бинарник годится только для того же драйвера той же версии
+    h = fnv1a(h, reinterpret_cast<const char*>(glGetString(GL_RENDERER)));
+    h = fnv1a(h, reinterpret_cast<const char*>(glGetString(GL_VERSION)));
+
+    char name[32];
+    std::snprintf(name, sizeof name, "%016llx.bin", static_cast<unsigned long long>(h));
+    return std::filesystem::path(m_cacheDir) / name;
+}
+
+/// Программа из кэша или 0 (нет файла, битый файл, драйвер отверг бинарник).
+GLuint ShaderProgram::loadBinary(const std::filesystem::path& path) const
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) return 0;
+
+    // Длина из заголовка должна совпасть с остатком файла — иначе битый заголовок
+    // заставил бы выделить до 4 ГБ ещё до проверки чтения
+    std::error_code ec;
+    const std::uintmax_t fileSize = std::filesystem::file_size(path, ec);
+
+    BinaryHeader hdr, expect;
+    std::vector<char> blob;
+    if (!ec && file.read(reinterpret_cast<char*>(&hdr), sizeof hdr) &&
+        std::memcmp(hdr.magic, expect.magic, sizeof hdr.magic) == 0 && hdr.version == expect.version &&
+        hdr.length == fileSize - sizeof hdr) {
+        blob.resize(hdr.length);
+        if (!file.read(blob.data(), std::streamsize(blob.size()))) blob.clear();
+    }
+    if (blob.empty()) {
+        std::cerr << "Shader cache: ignoring damaged entry " << path << "\n";
+        return 0;
+    }
+
+    GLuint program = glCreateProgram();
+    binaryApi().programBinary(program, hdr.format, blob.data(), GLsizei(blob.size()));
+    GLint success = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &success);
+    if (!success) {
+        // Драйвер обновился «тихо» или формат больше не поддерживается — соберём заново
+        std::cerr << "Shader cache: driver rejected " << path << ", recompiling\n";
+        glDeleteProgram(program);
+        return 0;
+    }
+    return program;
+}
+
+/// Пишет бинарник во временный файл и переименовывает — недописанных записей не бывает.
+void ShaderProgram::saveBinary(GLuint program, const std::filesystem::path& path) const
+{
+    GLint length = 0;
+    glGetProgramiv(program, kProgramBinaryLength, &length);
+    if (length <= 0) return;
+
+    BinaryHeader hdr;
+    std::vector<char> blob(static_cast<std::size_t>(length));
+    GLsizei written = 0;
+    binaryApi().getProgramBinary(program, length, &written, &hdr.format, blob.data());
+    if (written <= 0) return;
+    hdr.length = static_cast<std::uint32_t>(written);
+
+    std::error_code ec;
+    std::filesystem::create_directories(path.parent_path(), ec);
+    auto tmp = path;
+    tmp += ".tmp";
+    {
+        std::ofstream file(tmp, std::ios::binary | std::ios::trunc);
+        if (!file.write(reinterpret_cast<const char*>(&hdr), sizeof hdr) ||
+            !file.write(blob.data(), written)) {
+            std::cerr << "Shader cache: failed to write " << tmp << "\n";
+            return;
+        }
+    }
+    std::filesystem::rename(tmp, path, ec);
+}
+
+/// Таблицы активных uniform'ов и атрибутов — один раз после линковки.
+void ShaderProgram::reflect()
+{
+    m_uniforms.clear();
+    m_attribs.clear();
+
+    GLint count = 0, maxLen = 0;
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(m_id, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLen);
+    std::vector<char> name(std::max(maxLen, 1));
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei len = 0;
+        Uniform u;
+        glGetActiveUniform(m_id, GLuint(i), GLsizei(name.size()), &len, &u.size, &u.type, name.data());
+        std::string key(name.data(), len);
+        u.location = glGetUniformLocation(m_id, key.c_str());
+        if (u.location < 0) continue;              // uniform из блока — у нас таких нет
+        // Массивы приходят как "name[0]" — доступны и по базовому имени
+        if (auto br = key.find('['); br != std::string::npos) key.resize(br);
+        m_uniforms[key] = u;
+    }
+
+    glGetProgramiv(m_id, GL_ACTIVE_ATTRIBUTES, &count);
+    glGetProgramiv(m_id, GL_ACTIVE_ATTRIBUTE_MAX_LENGTH, &maxLen);
+    name.assign(std::max(maxLen, 1), '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei len = 0;
+        GLint   size = 0;
+        GLenum  type = 0;
+        glGetActiveAttrib(m_id, GLuint(i), GLsizei(name.size()), &len, &size, &type, name.data());
+        std::string key(name.data(), len);
+        m_attribs[key] = glGetAttribLocation(m_id, key.c_str());
+    }
+}
+
+int ShaderProgram::uniformLocation(const std::string& name) const
+{
+    auto it = m_uniforms.find(name);
+    return it == m_uniforms.end() ? -1 : it->second.location;
+}
+
+int ShaderProgram::attribLocation(const std::string& name) const
+{
+    auto it = m_attribs.find(name);
+    return it == m_attribs.end() ? -1 : it->second;
+}
+
+ShaderProgram::Uniform* ShaderProgram::changed(const std::string& name, const float* data, std::size_t count)
+{
+    auto it = m_uniforms.find(name);
+    if (it == m_uniforms.end()) return nullptr;
+
+    Uniform& u = it->second;
+    const std::size_t bytes = count * sizeof(float);
+    if (u.cached && std::memcmp(u.value.data(), data, bytes) == 0) return nullptr;
+    std::memcpy(u.value.data(), data, bytes);
+    u.cached = true;
+    return &u;
+}
+
+void ShaderProgram::set(const std::string& name, float v)
+{
+    if (Uniform* u = changed(name, &v, 1)) glUniform1f(u->location, v);
+}
+
+void ShaderProgram::set(const std::string& name, int v)
+{
+    float bits;
+    static_assert(sizeof bits == sizeof v);
+    std::memcpy(&bits, &v, sizeof v);             // сравниваем побитово, как и float'ы
+    if (Uniform* u = changed(name, &bits, 1)) glUniform1i(u->location, v);
+}
+
+void ShaderProgram::set(const std::string& name, const glm::vec3& v)
+{
+    if (Uniform* u = changed(name, glm::value_ptr(v), 3)) glUniform3fv(u->location, 1, glm::value_ptr(v));
+}
+
+void ShaderProgram::set(const std::string& name, const glm::vec4& v)
+{
+    if (Uniform* u = changed(name, glm::value_ptr(v), 4)) glUniform4fv(u->location, 1, glm::value_ptr(v));
+}
+
+void ShaderProgram::set(const std::string& name, const glm::mat4& m)
+{
+    if (Uniform* u = changed(name, glm::value_ptr(m), 16)) glUniformMatrix4fv(u->location, 1, GL_FALSE, glm::value_ptr(m));
+}
@@ -0,0 +1,239 @@
+#include "replay/InputLog.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include "replay/ReplayFormat.hpp"
+
+namespace replay {
+
+namespace {
+
+    template <class T>
+    void putRaw(std::vector<std::uint8_t>& out, const T& v)
+    {
+        const auto* p = reinterpret_cast<const std::uint8_t*>(&v);
+        out.insert(out.end(), p, p + sizeof v);
+    }
+
+    template <class T>
+    bool getRaw(const std::uint8_t*& p, const std::uint8_t* end, T& v)
+    {
+        if (static_cast<std::size_t>(end - p) < sizeof v) return false;
+        std::memcpy(&v, p, sizeof v);
+        p += sizeof v;
+        return true;
+    }
+
+    void packTable(const sim::TableConfig& c, float (&t)[10])
+    {
+        const float v[10] = { c.widthPx, c.heightPx, c.cushionPx, c.ballRadiusPx, c.pocketRadiusPx,
+                              c.rackGapPx, c.cueStartPx.x, c.cueStartPx.y, c.rackApexPx.x, c.rackApexPx.y };
+        std::memcpy(t, v, sizeof v);
+    }
+
+    sim::TableConfig unpackTable(const float (&t)[10])
+    {
+        sim::TableConfig c;
+        c.widthPx        = t[0];
+        c.heightPx       = t[1];
+        c.cushionPx      = t[2];
+        c.ballRadiusPx   = t[3];
+        c.pocketRadiusPx = t[4];
+        c.rackGapPx      = t[5];
+        c.cueStartPx     = { t[6], t[7] };
+        c.rackApexPx     = { t[8], t[9] };
+        return c;
+    }
+
+} // namespace
+
+// ─── InputLog ────────────────────────────────────────────────────────
+
+std::size_t InputLog::save(const std::string& path) const
+{
+    std::vector<std::uint8_t> out;
+    InputHeader h{ { kInputMagic[0], kInputMagic[1], kInputMagic[2], kInputMagic[3] }, kInputVersion,
+                   static_cast<std::uint8_t>(backend), 0, step, checkpointTicks, {}, rackHash };
+    packTable(cfg, h.table);
+    putRaw(out, h);
+
+    // Удары и контрольные точки — одним потоком по тикам; точка тика t раньше
+    // удара с тем же t (она — после тика t, удар — перед следующим)
+    std::uint64_t last = 0;
+    auto shot  = shots.begin();
+    auto check = checkpoints.begin();
+    while (shot != shots.end() || check != checkpoints.end()) {
+        if (check != checkpoints.end() && (shot == shots.end() || check->tick <= shot->tick)) {
+            out.push_back(kInputCheck);
+            putVarint(out, check->tick - last);
+            putRaw(out, check->hash);
+            last = check->tick;
+            ++check;
+        } else {
+            out.push_back(kInputShot);
+            putVarint(out, shot->tick - last);
+            putVarint(out, static_cast<std::uint64_t>(shot->slot));
+            putRaw(out, shot->impulse.x);
+            putRaw(out, shot->impulse.y);
+            last = shot->tick;
+            ++shot;
+        }
+    }
+    out.push_back(kInputEnd);
+    putVarint(out, ticks - last);
+    putRaw(out, finalHash);
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(out.data()), static_cast<std::streamsize>(out.size()));
+    return file ? out.size() : 0;
+}
+
+bool InputLog::load(const std::string& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return false;
+    const std::vector<std::uint8_t> data{ std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+
+    const std::uint8_t* p   = data.data();
+    const std::uint8_t* end = p + data.size();
+    InputHeader h{};
+    if (!getRaw(p, end, h) || std::memcmp(h.magic, kInputMagic, sizeof kInputMagic) != 0 ||
+        h.version != kInputVersion || h.backend > static_cast<std::uint8_t>(physics::Backend::Analytic))
+        return false;
+
+    cfg             = unpackTable(h.table);
+    backend         = static_cast<physics::Backend>(h.backend);
+    step            = h.step;
+    checkpointTicks = h.checkpointTicks;
+    rackHash        = h.rackHash;
+    shots.clear();
+    checkpoints.clear();
+
+    std::uint64_t tick = 0, dt = 0;
+    while (p < end) {
+        const std::uint8_t tag = *p++;
+        if (!getVarint(p, end, dt)) return false;
+        tick += dt;
+        switch (tag) {
+        case kInputShot: {
+            std::uint64_t slot;
+            InputShot s{ tick, 0, {} };
+            if (!getVarint(p, end, slot) || !getRaw(p, end, s.impulse.x) || !getRaw(p, end, s.impulse.y))
+                return false;
+            s.slot = static_cast<int>(slot);
+            shots.push_back(s);
+            break;
+        }
+        case kInputCheck: {
+            InputCheckpoint c{ tick, 0 };
+            if (!getRaw(p, end, c.hash)) return false;
+            checkpoints.push_back(c);
+            break;
+        }
+        case kInputEnd:
+            ticks = tick;
+            return getRaw(p, end, finalHash);
+        default:
+            return false;
+        }
+    }
+    return false;   // без kInputEnd — оборванная запись, сверять нечего
+}
+
+// ─── InputRecorder ───────────────────────────────────────────────────
+
+void InputRecorder::begin(const sim::Simulation& table, float step, std::uint32_t checkpointTicks)
+{
+    m_log                 = {};
+    m_log.cfg             = table.config();
+    m_log.backend         = table.world().backend();
+    m_log.step            = step;
+    m_log.checkpointTicks = std::max<std::uint32_t>(checkpointTicks, 1);
+    m_log.rackHash        = table.world().stateHash();
+    m_log.finalHash       = m_log.rackHash;
+    m_checkHash           = m_log.rackHash;
+    m_checkTick           = 0;
+}
+
+void InputRecorder::shot(std::uint64_t tick, int slot, const b2Vec2& impulse)
+{
+    m_log.shots.push_back({ tick, slot, impulse });
+}
+
+void InputRecorder::tick(std::uint64_t tick, const sim::Simulation& table)
+{
+    const physics::World& world = table.world();
+    const std::uint64_t   hash  = world.stateHash();
+    m_log.ticks     = tick;
+    m_log.finalHash = hash;
+
+    // Стоящий стол хеш не меняет — точки только пока шары катятся и в тик остановки
+    if (hash != m_checkHash && (tick - m_checkTick >= m_log.checkpointTicks || world.idle())) {
+        m_log.checkpoints.push_back({ tick, static_cast<std::uint32_t>(hash) });
+        m_checkHash = hash;
+        m_checkTick = tick;
+    }
+}
+
+// ─── Повтор ──────────────────────────────────────────────────────────
+
+InputVerdict replayInputs(const InputLog& log, sim::Simulation& table,
+                          const std::function<void(std::uint64_t, const sim::Simulation&)>& onTick)
+{
+    InputVerdict v;
+    physics::World& world = table.world();
+    if (world.stateHash() != log.rackHash) return v;   // другая расстановка или другой код rack()
+
+    std::size_t   shot = 0;
+    std::uint64_t tick = 0;
+    auto check = [&] {
+        // Точки, пропущенные промоткой простоя, сверяются с тем же хешем — стол стоял
+        for (; v.checked < log.checkpoints.size() && log.checkpoints[v.checked].tick <= tick; ++v.checked) {
+            const InputCheckpoint& c = log.checkpoints[v.checked];
+            if (static_cast<std::uint32_t>(world.stateHash()) != c.hash) {
+                v.diverged = c.tick;
+                return false;
+            }
+            v.lastGood = c.tick;
+        }
+        return true;
+    };
+
+    while (tick < log.ticks) {
+        for (; shot < log.shots.size() && log.shots[shot].tick <= tick; ++shot) {
+            const InputShot& s = log.shots[shot];
+            if (s.slot < 0 || static_cast<std::size_t>(s.slot) >= world.balls().size()) {
+                v.diverged = tick;
+                v.ticks    = tick;
+                return v;
+            }
+            world.applyImpulse(s.slot, s.impulse);
+        }
+
+        if (world.idle() && !onTick) {
+            // До следующего удара ничего не сдвинется
+            tick = shot < log.shots.size() ? std::min(log.shots[shot].tick, log.ticks) : log.ticks;
+        } else {
+            table.tick(log.step);
+            ++tick;
+            if (onTick) onTick(tick, table);
+        }
+        if (!check()) {
+            v.ticks = tick;
+            return v;
+        }
+    }
+
+    v.ticks = tick;
+    if (world.stateHash() != log.finalHash) {
+        v.diverged = tick;
+        return v;
+    }
+    v.lastGood = tick;
+    v.ok       = true;
+    return v;
+}
+
+} // namespace replay
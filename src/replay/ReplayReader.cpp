@@ -0,0 +1,294 @@
+#include "replay/ReplayReader.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#if defined(_WIN32)
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#else
+#   include <fcntl.h>
+#   include <sys/mman.h>
+#   include <sys/stat.h>
+#   include <unistd.h>
+#endif
+
+namespace replay {
+
+ReplayReader::~ReplayReader()
+{
+    close();
+}
+
+bool ReplayReader::map(const std::string& path)
+{
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                              OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER size{};
+    HANDLE mapping = nullptr;
+    if (GetFileSizeEx(file, &size) && size.QuadPart > 0)
+        mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (!mapping) return false;
+    // Вид держит отображение сам — дескрипторы больше не нужны
+    void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (!view) return false;
+    m_data = static_cast<const std::uint8_t*>(view);
+    m_size = static_cast<std::size_t>(size.QuadPart);
+#else
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) return false;
+    struct stat st{};
+    void* view = MAP_FAILED;
+    if (::fstat(fd, &st) == 0 && st.st_size > 0)
+        view = ::mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);   // отображение живёт и без дескриптора
+    if (view == MAP_FAILED) return false;
+    m_data = static_cast<const std::uint8_t*>(view);
+    m_size = static_cast<std::size_t>(st.st_size);
+#endif
+    return true;
+}
+
+void ReplayReader::unmap()
+{
+    if (!m_data) return;
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+#else
+    ::munmap(const_cast<std::uint8_t*>(m_data), m_size);
+#endif
+    m_data = nullptr;
+    m_size = 0;
+}
+
+bool ReplayReader::open(const std::string& path)
+{
+    close();
+    if (!map(path)) return false;
+
+    if (m_size < sizeof(FileHeader)) { close(); return false; }
+    std::memcpy(&m_header, m_data, sizeof m_header);
+    if (std::memcmp(m_header.magic, kMagic, sizeof kMagic) != 0 || m_header.version != kVersion) {
+        close();
+        return false;
+    }
+
+    // Оглавление из хвоста; если хвоста нет или он не сходится — файл обрезан
+    m_end = m_data + m_size;
+    IndexTrailer trailer{};
+    if (m_size >= sizeof(FileHeader) + sizeof trailer)
+        std::memcpy(&trailer, m_data + m_size - sizeof trailer, sizeof trailer);
+    const bool indexed = std::memcmp(trailer.magic, kIndexMagic, sizeof kIndexMagic) == 0 &&
+                         trailer.indexOffset >= sizeof(FileHeader) &&
+                         trailer.indexOffset + std::uint64_t(trailer.count) * sizeof(IndexEntry) + sizeof trailer == m_size;
+    if (indexed) {
+        m_index.resize(trailer.count);
+        std::memcpy(m_index.data(), m_data + trailer.indexOffset, trailer.count * sizeof(IndexEntry));
+        m_end       = m_data + trailer.indexOffset;
+        m_ticks     = trailer.ticks;
+        m_truncated = false;
+    } else if (!buildIndex()) {
+        close();
+        return false;
+    }
+
+    if (m_index.empty() || m_ticks == 0) { close(); return false; }
+    return seek(0);
+}
+
+void ReplayReader::close()
+{
+    unmap();
+    m_index.clear();
+    m_ticks = 0;
+    m_p = m_end = nullptr;
+    m_idleLeft = 0;
+}
+
+bool ReplayReader::buildIndex()
+{
+    // Один проход по всей записи: ключи — в оглавление, последний целый тик — конец
+    m_truncated = true;
+    m_index.clear();
+    m_p        = m_data + sizeof(FileHeader);
+    m_idleLeft = 0;
+    bool any = false;
+    for (;;) {
+        const std::uint8_t* rec = m_p;
+        if (m_idleLeft == 0 && rec < m_end && *rec == kKeyframe) {
+            if (!advance()) break;
+            m_index.push_back({ m_tick, static_cast<std::uint64_t>(rec - m_data) });
+        } else if (!advance()) {
+            break;
+        }
+        any = true;
+    }
+    m_ticks = any ? m_tick + 1 : 0;
+    return any;
+}
+
+bool ReplayReader::seek(std::uint64_t tick)
+{
+    if (!isOpen()) return false;
+    tick = std::min(tick, m_ticks - 1);
+
+    // Последний ключ не позже tick; раньше первого ключа встать нельзя
+    auto it = std::upper_bound(m_index.begin(), m_index.end(), tick,
+                               [](std::uint64_t t, const IndexEntry& e) { return t < e.tick; });
+    if (it != m_index.begin()) --it;
+
+    m_p        = m_data + it->offset;
+    m_idleLeft = 0;
+    if (!advance()) return false;
+
+    while (m_tick < tick) {
+        // Простой стоящего стола проматывается разом, без пошагового предсказания
+        if (m_idleLeft > 0 &&
+            std::all_of(m_dx.begin(), m_dx.end(), [](std::int32_t d) { return d == 0; }) &&
+            std::all_of(m_dy.begin(), m_dy.end(), [](std::int32_t d) { return d == 0; })) {
+            const std::uint64_t n = std::min(m_idleLeft, tick - m_tick);
+            m_idleLeft -= n;
+            m_tick     += n;
+            continue;
+        }
+        if (!advance()) break;
+    }
+    publish();
+    return m_tick == tick;
+}
+
+bool ReplayReader::next()
+{
+    if (!isOpen() || m_tick + 1 >= m_ticks || !advance()) return false;
+    publish();
+    return true;
+}
+
+bool ReplayReader::advance()
+{
+    if (m_idleLeft > 0) {
+        --m_idleLeft;
+        predict();
+        ++m_tick;
+        return true;
+    }
+
+    const std::size_t n = m_qx.size();
+    std::uint64_t v = 0;
+    while (m_p < m_end) {
+        switch (*m_p++) {
+        case kScore:
+            if (!getVarint(m_p, m_end, v)) return false;
+            m_score = static_cast<int>(v);
+            break;
+
+        case kAlive: {
+            if (!getVarint(m_p, m_end, v) || v >= n) return false;
+            m_alive[v] ^= 1;
+            m_dx[v] = m_dy[v] = 0;
+            if (m_alive[v]) {
+                std::int32_t qx, qy;
+                if (!getZigzag(m_p, m_end, qx) || !getZigzag(m_p, m_end, qy) ||
+                    !getZigzag(m_p, m_end, m_dx[v]) || !getZigzag(m_p, m_end, m_dy[v])) return false;
+                m_qx[v] = qx * (1 << kFracBits);
+                m_qy[v] = qy * (1 << kFracBits);
+            }
+            break;
+        }
+
+        case kIdle:
+            if (!getVarint(m_p, m_end, v)) return false;
+            if (v == 0) break;
+            m_idleLeft = v - 1;
+            predict();
+            ++m_tick;
+            return true;
+
+        case kDelta: {
+            const std::size_t maskBytes = (n + 7) / 8;
+            if (static_cast<std::size_t>(m_end - m_p) < maskBytes) return false;
+            const std::uint8_t* mask = m_p;
+            m_p += maskBytes;
+            predict();
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!(mask[i / 8] & (1u << (i % 8)))) continue;
+                std::int32_t ex, ey, vx, vy;
+                if (!getZigzag(m_p, m_end, ex) || !getZigzag(m_p, m_end, ey) ||
+                    !getZigzag(m_p, m_end, vx) || !getZigzag(m_p, m_end, vy)) return false;
+                m_qx[i] = (roundFrac(m_qx[i]) + ex) * (1 << kFracBits);
+                m_qy[i] = (roundFrac(m_qy[i]) + ey) * (1 << kFracBits);
+                m_dx[i] += vx;
+                m_dy[i] += vy;
+            }
+            ++m_tick;
+            return true;
+        }
+
+        case kKeyframe:
+            return readKeyframe();
+
+        default:   // kEnd или мусор — дальше тиков нет
+            m_p = m_end;
+            return false;
+        }
+    }
+    return false;
+}
+
+bool ReplayReader::readKeyframe()
+{
+    std::uint64_t tick, score, n, r;
+    if (!getVarint(m_p, m_end, tick) || !getVarint(m_p, m_end, score) || !getVarint(m_p, m_end, n))
+        return false;
+    if (n > static_cast<std::uint64_t>(m_end - m_p)) return false;   // по байту на слот минимум
+
+    m_qx.resize(n);  m_qy.resize(n);
+    m_dx.resize(n);  m_dy.resize(n);
+    m_alive.resize(n);
+    m_balls.resize(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        if (m_p >= m_end) return false;
+        m_alive[i] = *m_p++ ? 1 : 0;
+        std::int32_t qx, qy;
+        if (!getVarint(m_p, m_end, r) || !getZigzag(m_p, m_end, qx) || !getZigzag(m_p, m_end, qy) ||
+            !getZigzag(m_p, m_end, m_dx[i]) || !getZigzag(m_p, m_end, m_dy[i])) return false;
+        m_qx[i]      = qx * (1 << kFracBits);
+        m_qy[i]      = qy * (1 << kFracBits);
+        m_balls.r[i] = static_cast<float>(r) / m_header.unitsPerMeter;
+    }
+    m_tick  = tick;
+    m_score = static_cast<int>(score);
+    return true;
+}
+
+void ReplayReader::predict()
+{
+    for (std::size_t i = 0; i < m_qx.size(); ++i) {
+        if (!m_alive[i]) continue;
+        m_dx[i] = decay(m_dx[i], m_header.decayQ16);
+        m_dy[i] = decay(m_dy[i], m_header.decayQ16);
+        m_qx[i] += m_dx[i];
+        m_qy[i] += m_dy[i];
+    }
+}
+
+void ReplayReader::publish()
+{
+    const float toM   = 1.f / (m_header.unitsPerMeter * float(1 << kFracBits));
+    const float toMps = toM / m_header.step;
+    for (std::size_t i = 0; i < m_qx.size(); ++i) {
+        m_balls.x[i]     = float(m_qx[i]) * toM;
+        m_balls.y[i]     = float(m_qy[i]) * toM;
+        m_balls.vx[i]    = float(m_dx[i]) * toMps;
+        m_balls.vy[i]    = float(m_dy[i]) * toMps;
+        m_balls.alive[i] = m_alive[i];
+        m_balls.awake[i] = (m_dx[i] | m_dy[i]) != 0;
+    }
+}
+
+} // namespace replay
@@ -0,0 +1,246 @@
+#include "replay/ReplayWriter.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+namespace replay {
+
+ReplayWriter::~ReplayWriter()
+{
+    close();
+}
+
+bool ReplayWriter::open(const std::string& path, float step, float damping)
+{
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) return false;
+
+    m_decay     = decayQ16(damping, step);
+    m_step      = step;
+    m_stepUnits = step * kUnitsPerMeter * float(1 << kFracBits);
+    FileHeader h{ { kMagic[0], kMagic[1], kMagic[2], kMagic[3] }, kVersion, 0, step, kUnitsPerMeter,
+                  m_decay, kTolerance };
+    m_file.write(reinterpret_cast<const char*>(&h), sizeof h);
+
+    m_block.clear();
+    m_block.reserve(kBlockBytes + 1024);
+    m_index.clear();
+    m_started = m_dirty = m_closing = false;
+    m_failed  = false;
+    m_idle  = 0;
+    m_bytes = sizeof h;
+    m_thread = std::thread([this] { run(); });
+    return true;
+}
+
+void ReplayWriter::record(std::uint64_t tick, const physics::BallStore& balls, int score)
+{
+    if (!isOpen() || m_failed) return;
+
+    // Первый тик, смена числа слотов, пропуск тиков и пора ставить ключ — полным состоянием
+    if (!m_started || balls.size() != m_qx.size() || tick != m_nextTick ||
+        (m_dirty && tick - m_keyTick >= kKeyframeTicks)) {
+        flushIdle();
+        writeKeyframe(tick, balls, score);
+        handOff();
+        return;
+    }
+    m_nextTick = tick + 1;
+
+    // 1) Счёт и выпавшие/вернувшиеся шары — отдельными записями перед тиком
+    if (score != m_score) {
+        flushIdle();
+        m_block.push_back(kScore);
+        putVarint(m_block, static_cast<std::uint64_t>(score));
+        m_score = score;
+        m_dirty = true;
+    }
+    const std::size_t n = balls.size();
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::uint8_t alive = balls.alive[i] ? 1 : 0;
+        if (alive == m_alive[i]) continue;
+        flushIdle();
+        m_block.push_back(kAlive);
+        putVarint(m_block, i);
+        m_alive[i] = alive;
+        m_dx[i] = m_dy[i] = 0;
+        if (alive) {
+            // Вернувшийся шар: позиция прошлого тика и скорость, ход тика — как у всех
+            const std::int32_t qx = quantize(balls.x[i] - balls.vx[i] * m_step);
+            const std::int32_t qy = quantize(balls.y[i] - balls.vy[i] * m_step);
+            m_qx[i] = qx << kFracBits;
+            m_qy[i] = qy << kFracBits;
+            m_dx[i] = velocity(balls.vx[i]);
+            m_dy[i] = velocity(balls.vy[i]);
+            putZigzag(m_block, qx);
+            putZigzag(m_block, qy);
+            putZigzag(m_block, m_dx[i]);
+            putZigzag(m_block, m_dy[i]);
+        }
+        m_dirty = true;
+    }
+
+    // 2) Предсказание, как у читателя; поправка — только если оно ушло дальше допуска
+    m_mask.assign((n + 7) / 8, 0);
+    m_residuals.clear();
+    bool moving = false;
+    for (std::size_t i = 0; i < n; ++i) {
+        if (!m_alive[i]) continue;
+        m_dx[i] = decay(m_dx[i], m_decay);
+        m_dy[i] = decay(m_dy[i], m_decay);
+        m_qx[i] += m_dx[i];
+        m_qy[i] += m_dy[i];
+
+        const std::int32_t qx = quantize(balls.x[i]), qy = quantize(balls.y[i]);
+        const std::int32_t ex = qx - roundFrac(m_qx[i]), ey = qy - roundFrac(m_qy[i]);
+        if (std::abs(ex) > kTolerance || std::abs(ey) > kTolerance) {
+            // Скорость — настоящая из BallStore, а не разность квантованных позиций:
+            // у той ошибка в единицу, и предсказание снова уехало бы за пару тиков
+            const std::int32_t vx = velocity(balls.vx[i]), vy = velocity(balls.vy[i]);
+            m_mask[i / 8] |= std::uint8_t(1u << (i % 8));
+            m_residuals.insert(m_residuals.end(), { ex, ey, vx - m_dx[i], vy - m_dy[i] });
+            m_qx[i] = qx << kFracBits;  m_dx[i] = vx;
+            m_qy[i] = qy << kFracBits;  m_dy[i] = vy;
+        }
+        moving = moving || m_dx[i] != 0 || m_dy[i] != 0;
+    }
+
+    if (m_residuals.empty()) {
+        ++m_idle;
+    } else {
+        flushIdle();
+        m_block.push_back(kDelta);
+        m_block.insert(m_block.end(), m_mask.begin(), m_mask.end());
+        for (std::int32_t r : m_residuals) putZigzag(m_block, r);
+    }
+    m_dirty = m_dirty || moving;
+
+    if (m_block.size() >= kBlockBytes || tick - m_handOffTick >= kFlushTicks)
+        handOff();
+}
+
+void ReplayWriter::writeKeyframe(std::uint64_t tick, const physics::BallStore& balls, int score)
+{
+    const std::size_t n = balls.size();
+    m_qx.resize(n);  m_qy.resize(n);
+    m_dx.resize(n);  m_dy.resize(n);
+    m_alive.resize(n);
+
+    // Ключ — точное состояние: к нему приходят и с начала файла, и после перемотки
+    m_index.push_back({ tick, m_bytes + m_block.size() });
+    m_block.push_back(kKeyframe);
+    putVarint(m_block, tick);
+    putVarint(m_block, static_cast<std::uint64_t>(score));
+    putVarint(m_block, n);
+    for (std::size_t i = 0; i < n; ++i) {
+        const std::int32_t qx = quantize(balls.x[i]), qy = quantize(balls.y[i]);
+        m_alive[i] = balls.alive[i] ? 1 : 0;
+        m_qx[i]    = qx << kFracBits;
+        m_qy[i]    = qy << kFracBits;
+        m_dx[i]    = m_alive[i] ? velocity(balls.vx[i]) : 0;
+        m_dy[i]    = m_alive[i] ? velocity(balls.vy[i]) : 0;
+        m_block.push_back(m_alive[i]);
+        putVarint(m_block, static_cast<std::uint32_t>(quantize(balls.r[i])));
+        putZigzag(m_block, qx);
+        putZigzag(m_block, qy);
+        putZigzag(m_block, m_dx[i]);
+        putZigzag(m_block, m_dy[i]);
+    }
+
+    m_score    = score;
+    m_keyTick  = tick;
+    m_nextTick = tick + 1;
+    m_started  = true;
+    m_dirty    = false;
+}
+
+std::int32_t ReplayWriter::velocity(float v) const
+{
+    return static_cast<std::int32_t>(std::lround(v * m_stepUnits));
+}
+
+void ReplayWriter::flushIdle()
+{
+    if (m_idle == 0) return;
+    m_block.push_back(kIdle);
+    putVarint(m_block, m_idle);
+    m_idle = 0;
+}
+
+void ReplayWriter::handOff()
+{
+    m_handOffTick = m_nextTick;
+    if (m_block.empty()) return;
+
+    m_bytes += m_block.size();
+    std::vector<std::uint8_t> next;
+    {
+        std::lock_guard lock(m_mutex);
+        if (m_queue.size() >= kMaxQueuedBlocks) {
+            // Диск встал: лучше оборванный, но целый файл, чем ждущая физика
+            m_failed = true;
+            m_block.clear();
+            return;
+        }
+        m_queue.push_back(std::move(m_block));
+        if (!m_spare.empty()) {
+            next = std::move(m_spare.back());
+            m_spare.pop_back();
+        }
+    }
+    m_cv.notify_one();
+
+    m_block = std::move(next);
+    m_block.clear();
+    if (m_block.capacity() == 0) m_block.reserve(kBlockBytes + 1024);
+}
+
+void ReplayWriter::close()
+{
+    if (!isOpen()) return;
+
+    if (!m_failed) {
+        flushIdle();
+        m_block.push_back(kEnd);
+        putVarint(m_block, m_nextTick);
+
+        IndexTrailer trailer{ m_bytes + m_block.size(), m_nextTick, static_cast<std::uint32_t>(m_index.size()),
+                              { kIndexMagic[0], kIndexMagic[1], kIndexMagic[2], kIndexMagic[3] } };
+        const auto* index = reinterpret_cast<const std::uint8_t*>(m_index.data());
+        m_block.insert(m_block.end(), index, index + m_index.size() * sizeof(IndexEntry));
+        const auto* tail = reinterpret_cast<const std::uint8_t*>(&trailer);
+        m_block.insert(m_block.end(), tail, tail + sizeof trailer);
+        handOff();
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_closing = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+    m_file.close();
+}
+
+void ReplayWriter::run()
+{
+    std::unique_lock lock(m_mutex);
+    for (;;) {
+        m_cv.wait(lock, [this] { return m_closing || !m_queue.empty(); });
+        if (m_queue.empty()) return;   // закрытие, всё записано
+
+        std::vector<std::uint8_t> block = std::move(m_queue.front());
+        m_queue.pop_front();
+
+        lock.unlock();
+        m_file.write(reinterpret_cast<const char*>(block.data()),
+                     static_cast<std::streamsize>(block.size()));
+        if (!m_file) m_failed = true;
+        block.clear();
+        lock.lock();
+
+        m_spare.push_back(std::move(block));
+    }
+}
+
+} // namespace replay
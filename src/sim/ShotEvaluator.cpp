@@ -0,0 +1,109 @@
+#include "sim/ShotEvaluator.hpp"
+
+#include <algorithm>
+
+namespace sim {
+
+ShotEvaluator::ShotEvaluator(const TableConfig& cfg, physics::Backend backend, unsigned threads, float dt)
+    : m_cfg(cfg)
+    , m_backend(backend)
+    , m_dt(dt)
+    , m_maxTicks(static_cast<long>(120.f / dt))   // как в billiards_sim: не дольше 120 с на удар
+{
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+
+    // Столы потоки строят сами — свой на каждого кандидата (см. run)
+    m_workers.resize(threads);
+    for (auto& w : m_workers)
+        w.thread = std::thread([this, &w] { workerLoop(w); });
+}
+
+ShotEvaluator::~ShotEvaluator()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (auto& w : m_workers)
+        w.thread.join();
+}
+
+void ShotEvaluator::evaluate(const Snapshot& start, const std::vector<b2Vec2>& impulses,
+                             std::vector<ShotOutcome>& out)
+{
+    out.resize(impulses.size());
+    if (impulses.empty()) return;
+
+    std::unique_lock lock(m_mutex);
+    m_start    = &start;
+    m_impulses = &impulses;
+    m_out      = &out;
+    m_next.store(0, std::memory_order_relaxed);
+    m_busy     = static_cast<unsigned>(m_workers.size());
+    ++m_generation;
+    m_wake.notify_all();
+
+    m_done.wait(lock, [this] { return m_busy == 0; });
+    m_start    = nullptr;
+    m_impulses = nullptr;
+    m_out      = nullptr;
+}
+
+std::vector<ShotOutcome> ShotEvaluator::evaluate(const Snapshot& start, const std::vector<b2Vec2>& impulses)
+{
+    std::vector<ShotOutcome> out;
+    evaluate(start, impulses, out);
+    return out;
+}
+
+void ShotEvaluator::workerLoop(Worker& worker)
+{
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+
+        // Задание неизменно, пока m_busy > 0 — читаем его без блокировки
+        const std::size_t n = m_impulses->size();
+        for (std::size_t i = m_next.fetch_add(1, std::memory_order_relaxed); i < n;
+             i = m_next.fetch_add(1, std::memory_order_relaxed))
+            run(worker, (*m_impulses)[i], (*m_out)[i]);
+
+        {
+            std::lock_guard lock(m_mutex);
+            if (--m_busy == 0) m_done.notify_one();
+        }
+    }
+}
+
+void ShotEvaluator::run(Worker& worker, const b2Vec2& impulse, ShotOutcome& out) const
+{
+    // Контакты с тёплым стартом и форма дерева broad-phase от прошлого кандидата
+    // пережили бы restore() — стол строим с нуля, итог зависит только от снимка и удара
+    worker.table = std::make_unique<Simulation>(m_cfg, m_backend);
+    Simulation& table = *worker.table;
+    table.restore(*m_start);
+    table.shoot(impulse);
+
+    const int cue = table.cueSlot();
+    out.potted.clear();
+    out.cuePotted = false;
+    out.ticks     = 0;
+    do {
+        table.tick(m_dt);
+        ++out.ticks;
+        for (int slot : table.pottedLastTick()) {
+            out.potted.push_back(slot);
+            out.cuePotted |= (slot == cue);
+        }
+    } while (!table.atRest() && out.ticks < m_maxTicks);
+
+    table.world().snapshot(out.final);
+}
+
+} // namespace sim
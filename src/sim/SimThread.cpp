@@ -0,0 +1,127 @@
+#include "sim/SimThread.hpp"
+
+#include <algorithm>
+#include "sim/FixedStepClock.hpp"
+#include "prof/Profiler.hpp"
+
+namespace sim {
+
+SimThread::SimThread(Simulation& table, float step)
+    : m_table(table)
+    , m_step(step)
+{}
+
+SimThread::~SimThread()
+{
+    stop();
+}
+
+void SimThread::start()
+{
+    if (m_thread.joinable()) return;
+
+    // Первый снимок — до запуска потока, чтобы latest() сразу было что отдать
+    m_states.write().prev = m_table.world().balls();
+    publish(std::chrono::steady_clock::now());
+    if (m_recorder) m_recorder->record(m_tick, m_table.world().balls(), m_table.score());
+    m_stop.store(false, std::memory_order_relaxed);
+    m_thread = std::thread([this] { run(); });
+}
+
+void SimThread::stop()
+{
+    m_stop.store(true, std::memory_order_relaxed);
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void SimThread::post(const Shot& shot)
+{
+    std::lock_guard lock(m_shotMutex);
+    m_shots.push_back(shot);
+}
+
+const FrameState& SimThread::latest()
+{
+    m_states.fetch();
+    return m_states.read();
+}
+
+float SimThread::alpha(const FrameState& s, std::chrono::steady_clock::time_point now) const
+{
+    const float since = std::chrono::duration<float>(now - s.stepTime).count();
+    return std::clamp(since / m_step, 0.f, 1.f);
+}
+
+void SimThread::run()
+{
+    using clock = std::chrono::steady_clock;
+
+    FixedStepClock simClock(m_step);
+    auto last = clock::now();
+    while (!m_stop.load(std::memory_order_relaxed)) {
+        auto now = clock::now();
+        int steps = simClock.advance(std::chrono::duration<float>(now - last).count());
+        last = now;
+
+        if (steps > 0) {
+            for (; steps > 0; --steps) {
+                applyShots();
+                if (steps == 1)   // состояние перед последним шагом — «prev» для интерполяции
+                    m_states.write().prev = m_table.world().balls();
+                m_table.tick(m_step);
+                ++m_tick;
+                if (m_recorder) {
+                    PROFILE_ZONE("replay.record");
+                    m_recorder->record(m_tick, m_table.world().balls(), m_table.score());
+                }
+                if (m_inputs) m_inputs->tick(m_tick, m_table);
+            }
+            // Последний шаг соответствует моменту now минус недобранный остаток
+            publish(now - std::chrono::duration_cast<clock::duration>(
+                              std::chrono::duration<float>(simClock.alpha() * m_step)));
+        }
+
+        // Спим до следующего шага; остаток аккумулятора уже учтён в alpha()
+        std::this_thread::sleep_for(std::chrono::duration<float>((1.f - simClock.alpha()) * m_step));
+    }
+}
+
+void SimThread::applyShots()
+{
+    {
+        std::lock_guard lock(m_shotMutex);
+        if (m_shots.empty()) return;
+        m_pending.swap(m_shots);
+    }
+
+    physics::World& world = m_table.world();
+    for (const Shot& shot : m_pending) {
+        // Шар могли забить или удалить, пока удар шёл из потока ввода
+        int slot = world.resolve(shot.ball);
+        if (slot < 0 || !world.balls().alive[slot]) continue;
+        world.applyImpulse(slot, shot.impulse);
+        if (m_inputs) m_inputs->shot(m_tick, slot, shot.impulse);
+    }
+    m_pending.clear();
+}
+
+void SimThread::publish(std::chrono::steady_clock::time_point stepTime)
+{
+    const physics::World&     world = m_table.world();
+    const physics::BallStore& balls = world.balls();
+
+    // Слот писателя переиспользуется: после первых кадров копирование без аллокаций.
+    // s.prev уже заполнен перед последним шагом (см. run)
+    FrameState& s = m_states.write();
+    s.balls = balls;
+    s.handles.resize(balls.size());
+    for (std::size_t i = 0; i < balls.size(); ++i)
+        s.handles[i] = world.handle(static_cast<int>(i));
+    s.score    = m_table.score();
+    s.atRest   = m_table.atRest();
+    s.tick     = m_tick;
+    s.stepTime = stepTime;
+    m_states.publish();
+}
+
+} // namespace sim
@@ -0,0 +1,177 @@
+#include "sim/Simulation.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include "prof/Profiler.hpp"
+
+using physics::Ball;
+
+namespace sim {
+
+b2Vec2 shotImpulse(const Vec2f& dragM, float maxDrag, float maxImpulse)
+{
+    // dragM — в метрах
+    float len = std::hypot(dragM.x, dragM.y);
+    if (len < 1e-4f) return {0.f, 0.f};
+
+    float clamped = std::min(len, maxDrag);
+    float scale   = (clamped / maxDrag) * maxImpulse;   // Н·с
+
+    return { dragM.x / len * scale, dragM.y / len * scale };
+}
+
+Simulation::Simulation(const TableConfig& cfg, physics::Backend backend)
+    : m_cfg(cfg)
+    , m_world(backend)
+    , m_table(m_world.raw(), cfg.widthPx, cfg.heightPx, cfg.cushionPx)
+    , m_pockets(physics::defaultPockets(cfg.widthPx, cfg.heightPx, cfg.pocketRadiusPx))
+{
+    // Сенсоры карманов висят на теле бортов; m_pockets к этому моменту уже заполнен
+    m_world.addPockets(m_table.body(), m_pockets);
+    rack();
+    m_world.mixStateHash();   // хеш начинается с расстановки
+}
+
+/// Биток + пирамида из 15 шаров (5 рядов) вершиной к битку.
+void Simulation::rack()
+{
+    m_balls.clear();
+    m_balls.reserve(16);
+    m_cue = m_balls.emplace(m_world, m_cfg.ballRadiusPx, m_cfg.cueStartPx);
+
+    const float R     = m_cfg.ballRadiusPx;
+    const float GAP   = m_cfg.rackGapPx;
+    const float STEPX = (2.f * R + GAP) * 0.8660254f;   // cos 30°
+    for (int row = 0; row < 5; ++row) {
+        float x  = m_cfg.rackApexPx.x + STEPX * row;
+        float y0 = m_cfg.rackApexPx.y - row * (R + GAP / 2.f);
+        for (int col = 0; col <= row; ++col) {
+            float y = y0 + col * (2.f * R + GAP);
+            m_balls.emplace(m_world, R, Vec2f{x, y});
+        }
+    }
+
+    // Исходная расстановка для rerack(): дальше тела только переставляются
+    m_world.snapshot(m_rack.world);
+    m_rack.score = 0;
+}
+
+void Simulation::rerack()
+{
+    restore(m_rack);
+}
+
+int Simulation::substepsFor(float dt) const
+{
+    if (m_world.backend() == physics::Backend::Analytic) return 1;
+
+    // Путь самого быстрого шара за dt в долях допустимого сдвига за подшаг
+    const float maxTravel = kMaxTravelPerSubstep * px2m(m_cfg.ballRadiusPx);
+    const float travel    = m_world.maxSpeed() * dt;
+    const int   n         = static_cast<int>(std::ceil(travel / maxTravel));
+    return std::clamp(n, 1, kMaxSubsteps);
+}
+
+int Simulation::tick(float dt)
+{
+    // 0) Стол в покое — делать нечего до следующего удара
+    if (m_world.idle()) {
+        m_lastSubsteps = 0;
+        m_lastPotted.clear();
+        return 0;
+    }
+
+    // 1) Физика: подшагов столько, чтобы быстрый шар не проскочил соседа или борт
+    {
+        PROFILE_ZONE("physics.step");
+        m_lastSubsteps = substepsFor(dt);
+        for (int i = 0; i < m_lastSubsteps; ++i)
+            m_world.step(dt / m_lastSubsteps);
+    }
+
+    // 2) Гасим остаточные скорости и усыпляем остановившиеся шары
+    {
+        PROFILE_ZONE("physics.settle");
+        settle();
+    }
+
+    // 3) Карманы
+    int potted;
+    {
+        PROFILE_ZONE("physics.pockets");
+        potted = potBalls();
+    }
+
+    // 4) Итог тика — в хеш истории (сверка повторов, см. replay::InputLog)
+    m_world.mixStateHash();
+    return potted;
+}
+
+void Simulation::settle()
+{
+    m_world.settle(physics::kRestLinearSpeed, physics::kRestAngularSpeed);
+}
+
+int Simulation::potBalls()
+{
+    // Попадания уже найдены в World::step (сенсоры Box2D или события решателя)
+    const int cue = cueSlot();
+    int potted = 0;
+    m_lastPotted.clear();
+    for (const auto& e : m_world.pocketEvents()) {
+        if (e.slot == cue) {
+            m_lastPotted.push_back(cue);
+            // Биток не снимаем — возвращаем на стартовую точку
+            m_world.teleport(cue, { px2m(m_cfg.cueStartPx.x), px2m(m_cfg.cueStartPx.y) });
+        } else if (m_world.balls().alive[e.slot]) {
+            // Тело не удаляем, а выключаем: restore() сможет вернуть шар на стол
+            m_world.pot(e.slot);
+            m_lastPotted.push_back(e.slot);
+            ++m_score;
+            ++potted;
+        }
+    }
+    m_world.clearPocketEvents();
+    return potted;
+}
+
+bool Simulation::shoot(const b2Vec2& impulse)
+{
+    const int cue = cueSlot();
+    if (cue < 0) return false;
+    m_world.applyImpulse(cue, impulse);
+    return true;
+}
+
+bool Simulation::atRest() const
+{
+    return m_world.atRest(physics::kRestLinearSpeed, physics::kRestAngularSpeed);
+}
+
+void Simulation::snapshot(Snapshot& out) const
+{
+    m_world.snapshot(out.world);
+    out.score = m_score;
+}
+
+void Simulation::restore(const Snapshot& snap)
+{
+    m_world.restore(snap.world);
+    m_score = snap.score;
+}
+
+int Simulation::cueSlot() const
+{
+    const Ball* cue = m_balls.get(m_cue);
+    return cue ? cue->slot() : -1;
+}
+
+int Simulation::ballsLeft() const
+{
+    const auto& alive = m_world.balls().alive;
+    int n = 0;
+    for (const auto& b : m_balls) n += alive[b.slot()];
+    return n;
+}
+
+} // namespace sim
@@ -0,0 +1,383 @@
+// billiards_bench — микробенчмарки горячих путей: шаг физики, карманы, ввод,
+// генерация мешей на CPU. Окно и контекст OpenGL не нужны.
+//
+// Каждый замер — серия выборок; выборка — столько вызовов подряд, чтобы она
+// длилась не меньше --min-sample-us (шаг физики — фиксированные kStepsPerSample
+// шагов от одного и того же снимка). Время вызова в выборке — среднее по ней;
+// по выборкам печатаются min / median / p99 и пишется JSON для сравнения сборок.
+//
+//   billiards_bench [--samples N] [--min-sample-us U] [--filter SUBSTR] [--json FILE] [--list]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "core/InputController.hpp"
+#include "physics/Ball.hpp"
+#include "physics/PocketKernel.hpp"
+#include "physics/Pockets.hpp"
+#include "physics/Table.hpp"
+#include "physics/World.hpp"
+#include "render/MeshBuilder.hpp"
+#include "sim/Simulation.hpp"
+
+namespace {
+
+    struct Options {
+        int         samples     = 100;
+        int         warmup      = 5;      // выборок перед замером, в статистику не идут
+        double      minSampleUs = 200.0;
+        std::string filter;
+        std::string json;
+        bool        list        = false;
+    };
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i) {
+            auto arg  = std::string(argv[i]);
+            auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+
+            const char* v = nullptr;
+            if      (arg == "--list")                           opt.list        = true;
+            else if (arg == "--samples"       && (v = next()))  opt.samples     = std::atoi(v);
+            else if (arg == "--min-sample-us" && (v = next()))  opt.minSampleUs = std::strtod(v, nullptr);
+            else if (arg == "--filter"        && (v = next()))  opt.filter      = v;
+            else if (arg == "--json"          && (v = next()))  opt.json        = v;
+            else {
+                std::cerr << "Usage: billiards_bench [--samples N] [--min-sample-us U] [--filter SUBSTR]"
+                             " [--json FILE] [--list]\n";
+                return false;
+            }
+        }
+        return opt.samples > 0 && opt.minSampleUs > 0.0;
+    }
+
+    /// Результаты сюда, чтобы компилятор не выбросил замеряемый код.
+    volatile std::uint64_t g_sink = 0;
+
+    /// Замер: setup() перед каждой выборкой (не замеряется), body(n) — n вызовов.
+    /// fixedIters > 0 — вызовов в выборке ровно столько, без подбора.
+    struct Benchmark {
+        std::string                          name;
+        std::function<void()>                setup;
+        std::function<void(std::uint64_t)>   body;
+        std::uint64_t                        fixedIters = 0;
+    };
+
+    struct Result {
+        std::string   name;
+        std::uint64_t iters = 0;              // вызовов в выборке
+        double        minNs = 0, medianNs = 0, p99Ns = 0, meanNs = 0;   // на вызов
+    };
+
+    double sampleNs(const Benchmark& b, std::uint64_t iters)
+    {
+        if (b.setup) b.setup();
+        const auto t0 = std::chrono::steady_clock::now();
+        b.body(iters);
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - t0).count();
+    }
+
+    Result run(const Benchmark& b, const Options& opt)
+    {
+        // Подбор длины выборки: удваиваем, пока она короче порога (разрешение таймера)
+        std::uint64_t iters = b.fixedIters;
+        if (iters == 0)
+            for (iters = 1; iters < (1ull << 30) && sampleNs(b, iters) < opt.minSampleUs * 1e3; iters *= 2) {}
+
+        for (int i = 0; i < opt.warmup; ++i) sampleNs(b, iters);
+
+        std::vector<double> perCall(static_cast<std::size_t>(opt.samples));
+        for (double& t : perCall) t = sampleNs(b, iters) / static_cast<double>(iters);
+        std::sort(perCall.begin(), perCall.end());
+
+        Result r;
+        r.name     = b.name;
+        r.iters    = iters;
+        r.minNs    = perCall.front();
+        r.medianNs = perCall[perCall.size() / 2];
+        r.p99Ns    = perCall[std::min(perCall.size() - 1,
+                                      static_cast<std::size_t>(std::ceil(0.99 * perCall.size())) - 1)];
+        double sum = 0;
+        for (double t : perCall) sum += t;
+        r.meanNs = sum / static_cast<double>(perCall.size());
+        return r;
+    }
+
+    // ─── Шаг физики ──────────────────────────────────────────────────
+
+    constexpr float         kStepDt          = 1.f / 120.f;   // как dt billiards_sim
+    constexpr std::uint64_t kStepsPerSample  = 60;            // 0.5 с от снимка
+
+    /// Стол с \p balls шарами сеткой по всему полю и случайными скоростями до 3 м/с.
+    /// Каждая выборка начинается с одного и того же снимка — разлёт не успевает затухнуть.
+    struct StepFixture {
+        sim::TableConfig            cfg;
+        physics::World              world;
+        physics::Table              table;
+        std::vector<physics::Ball>  balls;
+        physics::WorldSnapshot      start;
+
+        StepFixture(int count, physics::Backend backend)
+            : world(backend)
+            , table(world.raw(), cfg.widthPx, cfg.heightPx, cfg.cushionPx)
+        {
+            world.addPockets(table.body(), physics::defaultPockets(cfg.widthPx, cfg.heightPx, cfg.pocketRadiusPx));
+
+            // Сетка с шагом в 3 радиуса — шары не перекрываются при любом count до ~900
+            const float pitch = 3.f * cfg.ballRadiusPx;
+            const float x0    = cfg.cushionPx + 2.f * cfg.ballRadiusPx;
+            const int   cols  = static_cast<int>((cfg.widthPx - 2.f * x0) / pitch);
+            balls.reserve(static_cast<std::size_t>(count));
+            for (int i = 0; i < count; ++i)
+                balls.emplace_back(world, cfg.ballRadiusPx,
+                                   Vec2f{ x0 + pitch * (i % cols), x0 + pitch * (i / cols) });
+
+            std::mt19937 rng(7);
+            std::uniform_real_distribution<float> u(-1.f, 1.f);
+            for (const physics::Ball& b : balls) {
+                const float m = b.body()->GetMass();
+                world.applyImpulse(b.slot(), { 2.f * m * u(rng), 2.f * m * u(rng) });
+            }
+            world.snapshot(start);
+        }
+
+        void reset()
+        {
+            world.restore(start);
+            world.clearPocketEvents();
+        }
+    };
+
+    void addStepBenchmarks(std::vector<Benchmark>& out)
+    {
+        struct Case { const char* backend; physics::Backend value; int balls; };
+        const Case cases[] = {
+            { "box2d",    physics::Backend::Box2D,    1 },
+            { "box2d",    physics::Backend::Box2D,    16 },
+            { "box2d",    physics::Backend::Box2D,    64 },
+            { "box2d",    physics::Backend::Box2D,    256 },
+            { "analytic", physics::Backend::Analytic, 16 },
+            { "analytic", physics::Backend::Analytic, 64 },
+        };
+        for (const Case& c : cases) {
+            auto fx = std::make_shared<StepFixture>(c.balls, c.value);
+            out.push_back({ std::string("World::step/") + c.backend + "/" + std::to_string(c.balls),
+                            [fx] { fx->reset(); },
+                            [fx](std::uint64_t n) {
+                                for (std::uint64_t i = 0; i < n; ++i) fx->world.step(kStepDt);
+                                g_sink = g_sink + static_cast<std::uint64_t>(fx->world.awakeCount());
+                            },
+                            kStepsPerSample });
+        }
+    }
+
+    // ─── Карманы, ввод, импульс ──────────────────────────────────────
+
+    constexpr std::size_t kPoints = 1024;   // степень двойки: индекс по маске
+
+    /// Точки по всему столу (м), детерминированно.
+    std::vector<Vec2f> randomPoints(const sim::TableConfig& cfg, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_real_distribution<float> ux(0.f, px2m(cfg.widthPx)), uy(0.f, px2m(cfg.heightPx));
+        std::vector<Vec2f> pts(kPoints);
+        for (Vec2f& p : pts) p = { ux(rng), uy(rng) };
+        return pts;
+    }
+
+    void addInputBenchmarks(std::vector<Benchmark>& out)
+    {
+        // Стандартная расстановка, как в main.cpp
+        auto table   = std::make_shared<sim::Simulation>();
+        auto pockets = std::make_shared<std::vector<physics::Pocket>>(table->pockets());
+        auto pts     = std::make_shared<std::vector<Vec2f>>(randomPoints(table->config(), 11));
+
+        // Точка против всех карманов — как проверка кандидата после подшага
+        out.push_back({ "inPocket/all-pockets", {},
+                        [pockets, pts](std::uint64_t n) {
+                            std::uint64_t hits = 0;
+                            for (std::uint64_t i = 0; i < n; ++i) {
+                                const Vec2f& p = (*pts)[i & (kPoints - 1)];
+                                for (const physics::Pocket& pk : *pockets)
+                                    hits += physics::inPocket(pk, p.x, p.y);
+                            }
+                            g_sink = g_sink + hits;
+                        } });
+
+        // Те же карманы пачкой по SoA-массивам (physics::pottedMask) против поштучного
+        // inPocket по тем же точкам: n вызовов — n пачек по kBatch шаров
+        auto xs = std::make_shared<std::vector<float>>();
+        auto ys = std::make_shared<std::vector<float>>();
+        for (const Vec2f& p : *pts) { xs->push_back(p.x); ys->push_back(p.y); }
+        for (std::size_t batch : { std::size_t{ 16 }, std::size_t{ 256 } }) {
+            out.push_back({ std::string("pottedMask/") + physics::pocketKernelIsa() + "/" + std::to_string(batch), {},
+                            [pockets, xs, ys, batch](std::uint64_t n) {
+                                std::uint64_t mask[kPoints / 64];
+                                std::uint64_t hits = 0;
+                                for (std::uint64_t i = 0; i < n; ++i) {
+                                    const std::size_t at = (i * batch) & (kPoints - 1);
+                                    physics::pottedMask(xs->data() + at, ys->data() + at, nullptr, batch,
+                                                        *pockets, mask);
+                                    hits += mask[0];
+                                }
+                                g_sink = g_sink + hits;
+                            } });
+            out.push_back({ "pottedMask/scalar-loop/" + std::to_string(batch), {},
+                            [pockets, xs, ys, batch](std::uint64_t n) {
+                                std::uint64_t hits = 0;
+                                for (std::uint64_t i = 0; i < n; ++i) {
+                                    const std::size_t at = (i * batch) & (kPoints - 1);
+                                    for (std::size_t k = 0; k < batch; ++k)
+                                        for (const physics::Pocket& pk : *pockets)
+                                            if (physics::inPocket(pk, (*xs)[at + k], (*ys)[at + k])) { ++hits; break; }
+                                }
+                                g_sink = g_sink + hits;
+                            } });
+        }
+
+        // Поиск шара под курсором на 16 шарах расстановки; половина точек — по шарам
+        auto ctl = std::make_shared<core::InputController>(2.0f, 0.2f);
+        auto cursor = std::make_shared<std::vector<sf::Vector2f>>();
+        const physics::BallStore& rack = table->world().balls();
+        for (std::size_t i = 0; i < kPoints; ++i) {
+            const std::size_t slot = i % rack.size();
+            const Vec2f& p = (*pts)[i];
+            cursor->push_back(i % 2 ? sf::Vector2f{ p.x, p.y } : sf::Vector2f{ rack.x[slot], rack.y[slot] });
+        }
+        out.push_back({ "InputController::findBallUnder/16", {},
+                        [table, ctl, cursor](std::uint64_t n) {
+                            const physics::BallStore& balls = table->world().balls();
+                            std::uint64_t sum = 0;
+                            for (std::uint64_t i = 0; i < n; ++i)
+                                sum += static_cast<std::uint64_t>(ctl->findBallUnder((*cursor)[i & (kPoints - 1)], balls) + 1);
+                            g_sink = g_sink + sum;
+                        } });
+
+        // Оттяжки от нуля до 1.5 × maxDrag: и линейная часть, и насыщение
+        auto drags = std::make_shared<std::vector<sf::Vector2f>>();
+        std::mt19937 rng(13);
+        std::uniform_real_distribution<float> ua(0.f, 6.2831853f), ul(0.f, 3.f);
+        for (std::size_t i = 0; i < kPoints; ++i) {
+            const float a = ua(rng), l = ul(rng);
+            drags->push_back({ l * std::cos(a), l * std::sin(a) });
+        }
+        out.push_back({ "InputController::computeImpulse", {},
+                        [ctl, drags](std::uint64_t n) {
+                            float sum = 0.f;
+                            for (std::uint64_t i = 0; i < n; ++i) {
+                                const b2Vec2 j = ctl->computeImpulse((*drags)[i & (kPoints - 1)]);
+                                sum += j.x + j.y;
+                            }
+                            g_sink = g_sink + static_cast<std::uint64_t>(std::abs(sum));
+                        } });
+    }
+
+    // ─── Меши (CPU-часть GLRenderer) ─────────────────────────────────
+
+    void addMeshBenchmarks(std::vector<Benchmark>& out)
+    {
+        struct SphereBuffers {
+            std::vector<render::SphereLod>    lods{ {4, 8}, {8, 16}, {16, 32}, {32, 64} };   // как в GLRenderer
+            std::vector<render::SphereVertex> vertices;
+            std::vector<std::uint32_t>        indices;
+        };
+        auto sphere = std::make_shared<SphereBuffers>();
+        out.push_back({ "GLRenderer::createSphereMesh/cpu", {},
+                        [sphere](std::uint64_t n) {
+                            for (std::uint64_t i = 0; i < n; ++i)
+                                render::buildSphereMesh(sphere->lods, sphere->vertices, sphere->indices);
+                            g_sink = g_sink + sphere->indices.size();
+                        } });
+
+        auto table = std::make_shared<std::vector<float>>();
+        out.push_back({ "GLRenderer::createTableMesh/cpu", {},
+                        [table](std::uint64_t n) {
+                            for (std::uint64_t i = 0; i < n; ++i)
+                                render::buildTableMesh(1280.f, 720.f, 20.f, *table);
+                            g_sink = g_sink + table->size();
+                        } });
+    }
+
+    // ─── Вывод ───────────────────────────────────────────────────────
+
+    bool writeJson(const std::string& path, const Options& opt, const std::vector<Result>& results)
+    {
+        std::ofstream f(path);
+        if (!f) return false;
+        f << "{\n"
+          << "  \"tool\": \"billiards_bench\",\n"
+#if defined(NDEBUG)
+          << "  \"build\": \"release\",\n"
+#else
+          << "  \"build\": \"debug\",\n"
+#endif
+#if defined(BILLIARDS_PROFILE)
+          << "  \"profile\": true,\n"
+#else
+          << "  \"profile\": false,\n"
+#endif
+          << "  \"samples\": " << opt.samples << ",\n"
+          << "  \"benchmarks\": [\n";
+        char line[512];
+        for (std::size_t i = 0; i < results.size(); ++i) {
+            const Result& r = results[i];
+            std::snprintf(line, sizeof line,
+                          "    { \"name\": \"%s\", \"iterations\": %llu, \"min_ns\": %.3f, "
+                          "\"median_ns\": %.3f, \"p99_ns\": %.3f, \"mean_ns\": %.3f }%s\n",
+                          r.name.c_str(), static_cast<unsigned long long>(r.iters),
+                          r.minNs, r.medianNs, r.p99Ns, r.meanNs, i + 1 < results.size() ? "," : "");
+            f << line;
+        }
+        f << "  ]\n}\n";
+        return static_cast<bool>(f);
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    std::vector<Benchmark> all;
+    addStepBenchmarks(all);
+    addInputBenchmarks(all);
+    addMeshBenchmarks(all);
+
+    if (opt.list) {
+        for (const Benchmark& b : all) std::cout << b.name << "\n";
+        return 0;
+    }
+
+    std::printf("%-36s %10s %12s %12s %12s\n", "benchmark", "iters", "min, ns", "median, ns", "p99, ns");
+    std::vector<Result> results;
+    for (const Benchmark& b : all) {
+        if (!opt.filter.empty() && b.name.find(opt.filter) == std::string::npos) continue;
+        const Result r = run(b, opt);
+        std::printf("%-36s %10llu %12.1f %12.1f %12.1f\n", r.name.c_str(),
+                    static_cast<unsigned long long>(r.iters), r.minNs, r.medianNs, r.p99Ns);
+        std::fflush(stdout);
+        results.push_back(r);
+    }
+
+    if (!opt.json.empty()) {
+        if (!writeJson(opt.json, opt, results)) {
+            std::cerr << "Cannot write " << opt.json << "\n";
+            return 1;
+        }
+        std::cout << "json:  " << opt.json << "\n";
+    }
+    return 0;
+}
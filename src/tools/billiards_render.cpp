@@ -0,0 +1,156 @@
+// billiards_render — отрисовка стола без окна: offscreen-контекст SFML + FBO.
+// Тот же GLRenderer::drawScene, что и в main.cpp, но кадры идут в renderbuffer,
+// а на выходе — время кадра и (по желанию) последний кадр в PPM.
+// Удобно гонять на программном растеризаторе Mesa:
+//
+//   LIBGL_ALWAYS_SOFTWARE=1 xvfb-run -a billiards_render [--frames N] [--size WxH]
+//                                                        [--impulse I] [--dist D] [--out frame.ppm]
+//                                                        [--shader-cache DIR | --no-shader-cache] [--impostors]
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <glad/glad.h>
+#include <SFML/Window.hpp>
+
+#include "render/GLRenderer.hpp"
+#include "sim/Simulation.hpp"
+
+namespace {
+
+    struct Options {
+        int         frames  = 300;
+        unsigned    width   = 1280;
+        unsigned    height  = 720;
+        float       impulse = 40.f;    // Н·с — разбой, чтобы шары разъехались по столу
+        float       dist    = 0.f;     // м, расстояние камеры; 0 — как в GLRenderer
+        bool        impostors = false; // шары импосторами вместо сфер
+        std::string out;
+        std::string shaderCache = "shader_cache";   // как в main.cpp
+    };
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i) {
+            auto arg  = std::string(argv[i]);
+            auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+
+            const char* v = nullptr;
+            if      (arg == "--frames"  && (v = next())) opt.frames  = std::atoi(v);
+            else if (arg == "--impulse" && (v = next())) opt.impulse = std::strtof(v, nullptr);
+            else if (arg == "--dist"    && (v = next())) opt.dist    = std::strtof(v, nullptr);
+            else if (arg == "--out"     && (v = next())) opt.out     = v;
+            else if (arg == "--shader-cache" && (v = next())) opt.shaderCache = v;
+            else if (arg == "--no-shader-cache") opt.shaderCache.clear();
+            else if (arg == "--impostors") opt.impostors = true;
+            else if (arg == "--size"    && (v = next()) &&
+                     std::sscanf(v, "%ux%u", &opt.width, &opt.height) == 2) {}
+            else {
+                std::cerr << "Usage: billiards_render [--frames N] [--size WxH] [--impulse I] [--dist D] [--out frame.ppm]\n"
+                             "                        [--shader-cache DIR | --no-shader-cache] [--impostors]\n";
+                return false;
+            }
+        }
+        return opt.frames > 0 && opt.width > 0 && opt.height > 0;
+    }
+
+    /// Читает текущий FBO и пишет бинарный PPM (строки снизу вверх → сверху вниз).
+    bool writePpm(const std::string& path, unsigned w, unsigned h)
+    {
+        std::vector<unsigned char> px(std::size_t(w) * h * 3);
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+        glReadPixels(0, 0, GLsizei(w), GLsizei(h), GL_RGB, GL_UNSIGNED_BYTE, px.data());
+
+        std::ofstream f(path, std::ios::binary);
+        if (!f) return false;
+        f << "P6\n" << w << ' ' << h << "\n255\n";
+        for (unsigned y = h; y-- > 0;)
+            f.write(reinterpret_cast<const char*>(&px[std::size_t(y) * w * 3]), std::streamsize(w) * 3);
+        return bool(f);
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+
+    // 1) Контекст OpenGL 3.3 core без окна
+    sf::ContextSettings settings{24, 8, 0, 3, 3, sf::ContextSettings::Core};
+    sf::Context context(settings, { opt.width, opt.height });
+    if (!context.setActive(true) ||
+        !gladLoadGLLoader(reinterpret_cast<GLADloadproc>(sf::Context::getFunction))) {
+        std::cerr << "Failed to create OpenGL context\n";
+        return 1;
+    }
+    std::cout << "renderer:   " << (const char*)glGetString(GL_RENDERER) << "\n"
+              << "version:    " << (const char*)glGetString(GL_VERSION)  << "\n";
+
+    // 2) FBO: цвет + глубина в renderbuffer'ах
+    GLuint fbo = 0, color = 0, depth = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+    glGenRenderbuffers(1, &color);
+    glBindRenderbuffer(GL_RENDERBUFFER, color);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, GLsizei(opt.width), GLsizei(opt.height));
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, color);
+    glGenRenderbuffers(1, &depth);
+    glBindRenderbuffer(GL_RENDERBUFFER, depth);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, GLsizei(opt.width), GLsizei(opt.height));
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depth);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        std::cerr << "Framebuffer incomplete\n";
+        return 1;
+    }
+
+    // 3) Рендерер и стол — как в main.cpp; время init — это в основном сборка шейдеров
+    render::GLRenderer renderer;
+    auto tInit = std::chrono::steady_clock::now();
+    if (!renderer.init("shaders", opt.shaderCache)) {
+        std::cerr << "Failed to initialize GLRenderer (shaders)\n";
+        return 1;
+    }
+    std::cout << "init:       "
+              << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - tInit).count()
+              << " ms\n";
+    renderer.resize(int(opt.width), int(opt.height));
+    if (opt.dist > 0.f) renderer.setCameraDistance(opt.dist);
+    if (opt.impostors)  renderer.setBallMode(render::BallMode::Impostor);
+    glViewport(0, 0, GLsizei(opt.width), GLsizei(opt.height));
+
+    sim::Simulation table;
+    const sim::TableConfig& cfg = table.config();
+    table.shoot({ opt.impulse, 0.f });
+
+    // 4) Кадры: шаг физики на 1/60 с + отрисовка; glFinish, чтобы мерить и работу GPU
+    double drawSeconds = 0.0;
+    long   drawCalls   = 0;
+    long   triangles   = 0;
+    for (int f = 0; f < opt.frames; ++f) {
+        table.tick(1.0f / 60.0f);
+
+        auto t0 = std::chrono::steady_clock::now();
+        renderer.drawScene(table.world().balls(), table.pockets(), cfg.widthPx, cfg.heightPx);
+        glFinish();
+        drawSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+        drawCalls   += renderer.lastDrawCalls();
+        triangles   += renderer.lastTriangles();
+    }
+
+    std::cout << "frames:     " << opt.frames << " @ " << opt.width << "x" << opt.height << "\n"
+              << "frame time: " << 1000.0 * drawSeconds / opt.frames << " ms\n"
+              << "draw calls: " << double(drawCalls) / opt.frames << " per frame\n"
+              << "triangles:  " << double(triangles) / opt.frames << " per frame\n";
+
+    if (!opt.out.empty() && !writePpm(opt.out, opt.width, opt.height)) {
+        std::cerr << "Failed to write " << opt.out << "\n";
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,573 @@
+// billiards_scenarios — сквозные сценарии без окна на стандартной расстановке
+// (та же sim::Simulation с TableConfig по умолчанию, что и в main.cpp, шаг 1/60 с):
+//
+//   break          — разбой битком в вершину пирамиды на полной силе, до остановки
+//   long-roll      — один медленный шар через полстола, остальные 15 спят
+//   cluster-split  — мягкий удар в пирамиду: плотная куча долго в контактах
+//   clearance      — автоигрок прицельными ударами сносит все 15 шаров
+//
+// На сценарий: симулированных секунд на секунду реального времени, вызовов
+// b2World::Step (подшагов), контактов шар–шар/шар–борт (касающихся, по тикам,
+// и пик за тик), забитых шаров и пиковая память. Удары заданы заранее, физика
+// детерминирована — все счётчики, кроме времени и памяти, от прогона к прогону
+// совпадают; при --repeat это проверяется, расхождение — код выхода 1. Код 1 и
+// у clearance, если за 150 ударов на столе остались прицельные шары.
+//
+// Каждый сценарий идёт в отдельном процессе (тот же бинарник с --child), поэтому
+// пиковая память — его собственная и не зависит от порядка и от --scenario.
+// С --in-process всё идёт в одном процессе, и память — пик всего процесса.
+//
+// С --baseline FILE результат сравнивается с базой (--write-baseline или --json
+// того же инструмента), по тем полям, что в ней есть: счётчики — в пределах
+// --tolerance в обе стороны (иначе поменялась физика), скорость — не ниже базы
+// больше чем на --time-tolerance, память — не выше. Сценарий без записи в базе —
+// тоже провал, если не задан --allow-new. Любой провал — код выхода 1.
+// --write-baseline пишет только счётчики: время и память от машины к машине разные.
+//
+//   billiards_scenarios [--scenario NAME] [--repeat N] [--json FILE] [--in-process]
+//                       [--baseline FILE] [--tolerance PCT] [--time-tolerance PCT] [--allow-new]
+//                       [--write-baseline FILE]
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#if defined(_WIN32)
+#   define WIN32_LEAN_AND_MEAN
+#   define NOMINMAX
+#   include <windows.h>
+#   include <psapi.h>
+#else
+#   include <sys/resource.h>
+#endif
+
+#include "sim/Simulation.hpp"
+
+namespace {
+
+    struct Options {
+        std::string scenario;             // пусто — все
+        int         repeat        = 3;    // прогонов на сценарий, в отчёт — самый быстрый
+        std::string json;
+        std::string baseline;
+        std::string writeBaseline;
+        double      tolerance     = 2.0;  // %, счётчики
+        double      timeTolerance = 25.0; // %, скорость и память
+        bool        allowNew      = false;
+        bool        inProcess     = false;
+        bool        child         = false; // внутренний: один сценарий, строка JSON в stdout
+    };
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i) {
+            auto arg  = std::string(argv[i]);
+            auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+
+            const char* v = nullptr;
+            if      (arg == "--allow-new")                       opt.allowNew      = true;
+            else if (arg == "--in-process")                      opt.inProcess     = true;
+            else if (arg == "--child")                           opt.child         = true;
+            else if (arg == "--scenario"       && (v = next()))  opt.scenario      = v;
+            else if (arg == "--repeat"         && (v = next()))  opt.repeat        = std::atoi(v);
+            else if (arg == "--json"           && (v = next()))  opt.json          = v;
+            else if (arg == "--baseline"       && (v = next()))  opt.baseline      = v;
+            else if (arg == "--write-baseline" && (v = next()))  opt.writeBaseline = v;
+            else if (arg == "--tolerance"      && (v = next()))  opt.tolerance     = std::strtod(v, nullptr);
+            else if (arg == "--time-tolerance" && (v = next()))  opt.timeTolerance = std::strtod(v, nullptr);
+            else {
+                std::cerr << "Usage: billiards_scenarios [--scenario NAME] [--repeat N] [--json FILE] [--in-process]\n"
+                             "                           [--baseline FILE] [--tolerance PCT] [--time-tolerance PCT]\n"
+                             "                           [--allow-new] [--write-baseline FILE]\n";
+                return false;
+            }
+        }
+        return opt.repeat > 0 && opt.tolerance >= 0.0 && opt.timeTolerance >= 0.0 &&
+               (!opt.child || !opt.scenario.empty());
+    }
+
+    /// Пиковая память процесса, КБ (высшая отметка с запуска процесса).
+    long peakRssKb()
+    {
+#if defined(_WIN32)
+        PROCESS_MEMORY_COUNTERS pmc{};
+        if (!GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof pmc)) return 0;
+        return static_cast<long>(pmc.PeakWorkingSetSize / 1024);
+#else
+        rusage ru{};
+        if (getrusage(RUSAGE_SELF, &ru) != 0) return 0;
+#   if defined(__APPLE__)
+        return static_cast<long>(ru.ru_maxrss / 1024);   // на macOS — байты
+#   else
+        return static_cast<long>(ru.ru_maxrss);
+#   endif
+#endif
+    }
+
+    struct Metrics {
+        long          shots        = 0;
+        long          ticks        = 0;
+        std::uint64_t b2Steps      = 0;   // вызовы b2World::Step = подшаги Simulation::tick
+        std::uint64_t contactSteps = 0;   // Σ по тикам касающихся контактов (без сенсоров карманов)
+        int           peakContacts = 0;   // наибольшее их число за тик
+        int           potted       = 0;   // прицельных шаров в лузах
+        double        wall         = 0.0; // с, только внутри Simulation::tick
+        long          peakRssKb    = 0;
+        std::string   failure;            // не пусто — сценарий не достиг цели (не в JSON)
+
+        [[nodiscard]] double simTime(float dt) const { return ticks * static_cast<double>(dt); }
+        [[nodiscard]] double simPerWall(float dt) const { return wall > 0.0 ? simTime(dt) / wall : 0.0; }
+    };
+
+    constexpr float kDt             = 1.f / 60.f;   // как SimThread в main.cpp
+    constexpr long  kMaxTicksPerShot = 120 * 60;    // 2 мин на удар — чтобы не зависнуть
+
+    /// Удары по битку и прогон до остановки; считает метрики.
+    class Runner {
+    public:
+        explicit Runner(sim::Simulation& table) : m_table(table) {}
+
+        void shoot(const b2Vec2& impulse)
+        {
+            m_table.shoot(impulse);
+            ++m.shots;
+            long n = 0;
+            do {
+                const auto t0 = std::chrono::steady_clock::now();
+                m.potted += m_table.tick(kDt);
+                m.wall   += std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+                ++m.ticks;
+                m.b2Steps += static_cast<std::uint64_t>(m_table.lastSubsteps());
+                countContacts();
+            } while (!m_table.atRest() && ++n < kMaxTicksPerShot);
+        }
+
+        /// Импульс, разгоняющий биток до \p speed м/с вдоль \p dir (единичный).
+        [[nodiscard]] b2Vec2 cueImpulse(const b2Vec2& dir, float speed) const
+        {
+            const float mass = m_table.world().body(m_table.cueSlot())->GetMass();
+            return { dir.x * speed * mass, dir.y * speed * mass };
+        }
+
+        [[nodiscard]] sim::Simulation& table() { return m_table; }
+        Metrics m;
+
+    private:
+        void countContacts()
+        {
+            int touching = 0;
+            for (const b2Contact* c = m_table.world().raw().GetContactList(); c; c = c->GetNext())
+                if (c->IsTouching() && !c->GetFixtureA()->IsSensor() && !c->GetFixtureB()->IsSensor())
+                    ++touching;
+            m.contactSteps += static_cast<std::uint64_t>(touching);
+            m.peakContacts  = std::max(m.peakContacts, touching);
+        }
+
+        sim::Simulation& m_table;
+    };
+
+    /// Единичный вектор от битка к точке \p px (пиксели стола).
+    b2Vec2 aimAt(const sim::Simulation& t, const Vec2f& px)
+    {
+        const physics::BallStore& b = t.world().balls();
+        const int cue = t.cueSlot();
+        b2Vec2 d{ px2m(px.x) - b.x[cue], px2m(px.y) - b.y[cue] };
+        d.Normalize();
+        return d;
+    }
+
+    // ─── Автоигрок для clearance ─────────────────────────────────────
+
+    constexpr float kRestitution  = 0.93f;   // как fd.restitution в Ball.cpp
+    constexpr float kArriveSpeed  = 0.6f;    // м/с, с которой прицельный должен дойти до лузы
+    constexpr float kMinCutCos    = 0.35f;   // срез не круче ~70°
+    constexpr float kMaxCueSpeed  = 8.f;     // м/с — разбой (40 Н·с в billiards_render)
+    constexpr float kSafetySpeed  = 3.f;     // м/с — нет прицельного: бьём ближний шар в лоб
+    constexpr int   kMaxClearanceShots = 150;
+
+    /// Удар по схеме «шар-призрак»: для каждой пары (прицельный, луза) с чистыми
+    /// траекториями биток→призрак и шар→луза — скорость битка, нужная, чтобы шар дошёл
+    /// до лузы с kArriveSpeed (линейное демпфирование теряет kBallLinearDamping м/с на
+    /// метр пути). Бьётся пара с наименьшей скоростью. Детерминирован, как и физика.
+    b2Vec2 planShot(Runner& run)
+    {
+        const sim::Simulation&    t   = run.table();
+        const physics::BallStore& b   = t.world().balls();
+        const sim::TableConfig&   cfg = t.config();
+        const int   cue  = t.cueSlot();
+        const float R    = px2m(cfg.ballRadiusPx);
+        const float c    = physics::kBallLinearDamping;
+        const float minX = px2m(cfg.cushionPx) + R, maxX = px2m(cfg.widthPx  - cfg.cushionPx) - R;
+        const float minY = px2m(cfg.cushionPx) + R, maxY = px2m(cfg.heightPx - cfg.cushionPx) - R;
+        const b2Vec2 C{ b.x[cue], b.y[cue] };
+        const int n = static_cast<int>(b.size());
+
+        // Ни один шар, кроме skipA/skipB, не ближе 2R к отрезку from→to
+        auto clear = [&](const b2Vec2& from, const b2Vec2& to, int skipA, int skipB) {
+            const b2Vec2 d = to - from;
+            const float len2 = std::max(b2Dot(d, d), 1e-8f);
+            for (int i = 0; i < n; ++i) {
+                if (!b.alive[i] || i == skipA || i == skipB) continue;
+                const b2Vec2 p{ b.x[i], b.y[i] };
+                const float  s = std::clamp(b2Dot(p - from, d) / len2, 0.f, 1.f);
+                const b2Vec2 q = p - (from + s * d);
+                if (b2Dot(q, q) < 4.f * R * R) return false;
+            }
+            return true;
+        };
+
+        float  best = std::numeric_limits<float>::max();
+        b2Vec2 bestDir{ 0.f, 0.f };
+        for (int o = 0; o < n; ++o) {
+            if (o == cue || !b.alive[o]) continue;
+            const b2Vec2 O{ b.x[o], b.y[o] };
+            for (const physics::Pocket& pk : t.pockets()) {
+                // Ближайшая к лузе точка, куда центр шара вообще может попасть
+                const b2Vec2 T{ std::clamp(pk.center.x, minX, maxX), std::clamp(pk.center.y, minY, maxY) };
+                b2Vec2 d = T - O;
+                const float dist = d.Normalize();
+                if (dist < 1e-4f) continue;
+
+                const b2Vec2 G = O - 2.f * R * d;   // где должен оказаться биток в момент удара
+                if (G.x < minX || G.x > maxX || G.y < minY || G.y > maxY) continue;
+                b2Vec2 u = G - C;
+                const float distC = u.Normalize();
+                if (distC < 1e-4f) continue;
+
+                const float cut = b2Dot(u, d);
+                if (cut < kMinCutCos || !clear(C, G, cue, o) || !clear(O, T, o, cue)) continue;
+
+                const float vObj   = c * dist + kArriveSpeed;
+                const float vImpact = vObj / (cut * 0.5f * (1.f + kRestitution));
+                const float v0     = vImpact + c * distC;
+                if (v0 < best) { best = v0; bestDir = u; }
+            }
+        }
+        if (best < std::numeric_limits<float>::max())
+            return run.cueImpulse(bestDir, std::min(best, kMaxCueSpeed));
+
+        // Чистого удара нет — разбиваем позицию: ближний шар в лоб
+        int   nearest = -1;
+        float near2   = std::numeric_limits<float>::max();
+        for (int o = 0; o < n; ++o) {
+            if (o == cue || !b.alive[o]) continue;
+            const b2Vec2 d{ b.x[o] - C.x, b.y[o] - C.y };
+            if (b2Dot(d, d) < near2) { near2 = b2Dot(d, d); nearest = o; }
+        }
+        if (nearest < 0) return { 0.f, 0.f };
+        b2Vec2 dir{ b.x[nearest] - C.x, b.y[nearest] - C.y };
+        dir.Normalize();
+        return run.cueImpulse(dir, kSafetySpeed);
+    }
+
+    // ─── Сценарии ────────────────────────────────────────────────────
+
+    struct Scenario {
+        const char*                  name;
+        std::function<void(Runner&)> play;
+    };
+
+    const std::vector<Scenario>& scenarios()
+    {
+        static const std::vector<Scenario> all = {
+            { "break", [](Runner& r) {
+                // 8 м/с ≈ 40 Н·с — тот же разбой, что у billiards_render
+                r.shoot(r.cueImpulse(aimAt(r.table(), r.table().config().rackApexPx), kMaxCueSpeed));
+            } },
+            { "long-roll", [](Runner& r) {
+                // Вдоль короткой оси, к борту: 2 м/с гаснут за ~2.2 м, до борта не доходит
+                r.shoot(r.cueImpulse({ 0.f, -1.f }, 2.f));
+            } },
+            { "cluster-split", [](Runner& r) {
+                // До пирамиды ~5.8 м: 6.5 м/с приходят к ней ~1.3 м/с — куча расползается, не разлетаясь
+                r.shoot(r.cueImpulse(aimAt(r.table(), r.table().config().rackApexPx), 6.5f));
+            } },
+            { "clearance", [](Runner& r) {
+                r.shoot(r.cueImpulse(aimAt(r.table(), r.table().config().rackApexPx), kMaxCueSpeed));
+                for (int shot = 1; shot < kMaxClearanceShots && r.table().ballsLeft() > 1; ++shot)
+                    r.shoot(planShot(r));
+                // Ослабший автоигрок виден и без базы: стол обязан опустеть
+                if (const int left = r.table().ballsLeft() - 1; left > 0)
+                    r.m.failure = std::to_string(left) + " object ball(s) left after " +
+                                  std::to_string(r.m.shots) + " shots";
+            } },
+        };
+        return all;
+    }
+
+    Metrics play(const Scenario& s)
+    {
+        sim::Simulation table;   // стандартная расстановка, Box2D — как в main.cpp
+        Runner run(table);
+        s.play(run);
+        run.m.peakRssKb = peakRssKb();
+        return run.m;
+    }
+
+    struct Row {
+        std::string name;
+        Metrics     m;
+        bool        ok = true;   // цель достигнута, прогоны совпали, дочерний процесс отработал
+    };
+
+    /// \p repeat прогонов в этом процессе: время — лучшее, счётчики обязаны совпасть.
+    Row playRepeated(const Scenario& s, int repeat)
+    {
+        Row row{ s.name, play(s) };
+        if (!row.m.failure.empty()) {
+            std::cerr << s.name << ": " << row.m.failure << "\n";
+            row.ok = false;
+        }
+        for (int i = 1; i < repeat; ++i) {
+            const Metrics m = play(s);
+            if (m.shots != row.m.shots || m.ticks != row.m.ticks || m.b2Steps != row.m.b2Steps ||
+                m.contactSteps != row.m.contactSteps || m.peakContacts != row.m.peakContacts ||
+                m.potted != row.m.potted) {
+                std::cerr << s.name << ": run " << i << " differs from run 0 — physics is not deterministic\n";
+                row.ok = false;
+            }
+            row.m.wall      = std::min(row.m.wall, m.wall);
+            row.m.peakRssKb = m.peakRssKb;
+        }
+        return row;
+    }
+
+    // ─── Отчёт и база ────────────────────────────────────────────────
+
+    /// Поля строки отчёта: имя в JSON, значение, как сравнивать с базой.
+    enum class Check { Exact, HigherBetter, LowerBetter };
+    struct Field {
+        const char* key;
+        double      value;
+        Check       check;
+    };
+
+    std::vector<Field> fields(const Metrics& m)
+    {
+        return {
+            { "shots",         static_cast<double>(m.shots),        Check::Exact },
+            { "ticks",         static_cast<double>(m.ticks),        Check::Exact },
+            { "b2_steps",      static_cast<double>(m.b2Steps),      Check::Exact },
+            { "contact_steps", static_cast<double>(m.contactSteps), Check::Exact },
+            { "peak_contacts", static_cast<double>(m.peakContacts), Check::Exact },
+            { "potted",        static_cast<double>(m.potted),       Check::Exact },
+            { "sim_per_wall",  m.simPerWall(kDt),                   Check::HigherBetter },
+            { "peak_rss_kb",   static_cast<double>(m.peakRssKb),    Check::LowerBetter },
+        };
+    }
+
+    /// Сценарий одной строкой JSON; \p countersOnly — без времени и памяти (для базы).
+    std::string rowJson(const Row& row, bool countersOnly)
+    {
+        std::string line = "{ \"name\": \"" + row.name + "\"";
+        char num[64];
+        for (const Field& fl : fields(row.m)) {
+            if (countersOnly && fl.check != Check::Exact) continue;
+            std::snprintf(num, sizeof num, "%.17g", fl.value);
+            line += std::string(", \"") + fl.key + "\": " + num;
+        }
+        return line + " }";
+    }
+
+    /// Отчёт — JSON, по сценарию на строку: его же читает --baseline.
+    bool writeJson(const std::string& path, const std::vector<Row>& rows, bool countersOnly)
+    {
+        std::ofstream f(path);
+        if (!f) return false;
+        f << "{\n  \"tool\": \"billiards_scenarios\",\n  \"dt\": " << kDt << ",\n";
+        if (countersOnly)
+            f << "  \"note\": \"counters of a Release build with the pinned Box2D; "
+                 "regenerate with billiards_scenarios --write-baseline\",\n";
+        f << "  \"scenarios\": [\n";
+        for (std::size_t i = 0; i < rows.size(); ++i)
+            f << "    " << rowJson(rows[i], countersOnly) << (i + 1 < rows.size() ? "," : "") << "\n";
+        f << "  ]\n}\n";
+        return static_cast<bool>(f);
+    }
+
+    /// Числовое поле "key": value из строки сценария; false — поля нет.
+    bool numberField(const std::string& line, const std::string& key, double& out)
+    {
+        const std::size_t at = line.find("\"" + key + "\":");
+        if (at == std::string::npos) return false;
+        const char* p   = line.c_str() + at + key.size() + 3;
+        char*       end = nullptr;
+        out = std::strtod(p, &end);
+        return end != p;
+    }
+
+    bool nameField(const std::string& line, std::string& out)
+    {
+        const std::string tag = "\"name\": \"";
+        const std::size_t at  = line.find(tag);
+        if (at == std::string::npos) return false;
+        const std::size_t close = line.find('"', at + tag.size());
+        if (close == std::string::npos) return false;
+        out = line.substr(at + tag.size(), close - at - tag.size());
+        return true;
+    }
+
+    /// Строка сценария (rowJson) обратно в Row; false — строка не про сценарий.
+    bool parseRow(const std::string& line, Row& row)
+    {
+        if (!nameField(line, row.name)) return false;
+        double v = 0.0;
+        bool   ok = true;
+        ok &= numberField(line, "shots",         v); row.m.shots        = static_cast<long>(v);
+        ok &= numberField(line, "ticks",         v); row.m.ticks        = static_cast<long>(v);
+        ok &= numberField(line, "b2_steps",      v); row.m.b2Steps      = static_cast<std::uint64_t>(v);
+        ok &= numberField(line, "contact_steps", v); row.m.contactSteps = static_cast<std::uint64_t>(v);
+        ok &= numberField(line, "peak_contacts", v); row.m.peakContacts = static_cast<int>(v);
+        ok &= numberField(line, "potted",        v); row.m.potted       = static_cast<int>(v);
+        ok &= numberField(line, "peak_rss_kb",   v); row.m.peakRssKb    = static_cast<long>(v);
+        // Время — обратно через sim_per_wall: wall = ticks·dt / sim_per_wall
+        ok &= numberField(line, "sim_per_wall",  v);
+        row.m.wall = v > 0.0 ? row.m.simTime(kDt) / v : 0.0;
+        return ok;
+    }
+
+    /// Сценарий в дочернем процессе (этот же бинарник с --child): своя пиковая память.
+    Row playChild(const char* self, const Scenario& s, int repeat)
+    {
+        Row row{ s.name, {} };
+        std::string cmd = std::string("\"") + self + "\" --child --scenario " + s.name +
+                          " --repeat " + std::to_string(repeat);
+#if defined(_WIN32)
+        cmd = "\"" + cmd + "\"";   // cmd.exe снимает внешние кавычки
+        FILE* pipe = _popen(cmd.c_str(), "r");
+#else
+        FILE* pipe = popen(cmd.c_str(), "r");
+#endif
+        if (!pipe) {
+            std::cerr << s.name << ": cannot start " << self << "\n";
+            row.ok = false;
+            return row;
+        }
+        std::string out;
+        char buf[512];
+        while (std::fgets(buf, sizeof buf, pipe)) out += buf;
+#if defined(_WIN32)
+        const int status = _pclose(pipe);
+#else
+        const int status = pclose(pipe);
+#endif
+        // Ненулевой код — прогоны разошлись (ребёнок уже написал в stderr) или упал
+        bool parsed = false;
+        std::istringstream lines(out);
+        for (std::string line; std::getline(lines, line);) parsed |= parseRow(line, row);
+        row.ok = parsed && status == 0;
+        if (!parsed) std::cerr << s.name << ": no result from child process (status " << status << ")\n";
+        return row;
+    }
+
+    /// Сравнить с базой. Возвращает число провалов: регрессии и (без --allow-new)
+    /// сценарии, которых нет в базе.
+    int compare(const std::string& path, const std::vector<Row>& rows, const Options& opt)
+    {
+        std::ifstream f(path);
+        if (!f) {
+            std::cerr << "Cannot read baseline " << path << "\n";
+            return 1;
+        }
+        std::vector<std::string> lines;
+        for (std::string line; std::getline(f, line);) lines.push_back(line);
+
+        int failures = 0;
+        std::printf("\nbaseline %s (tolerance %.1f%%, time/memory %.1f%%)\n",
+                    path.c_str(), opt.tolerance, opt.timeTolerance);
+        for (const Row& row : rows) {
+            const std::string* base = nullptr;
+            for (const std::string& line : lines)
+                if (std::string name; nameField(line, name) && name == row.name) base = &line;
+            if (!base) {
+                std::printf("  %-14s no baseline entry%s\n", row.name.c_str(), opt.allowNew ? "" : "  FAIL");
+                if (!opt.allowNew) ++failures;
+                continue;
+            }
+            for (const Field& fl : fields(row.m)) {
+                double was;
+                if (!numberField(*base, fl.key, was)) continue;
+                const double tol   = (fl.check == Check::Exact ? opt.tolerance : opt.timeTolerance) / 100.0;
+                const double delta = was != 0.0 ? (fl.value - was) / std::abs(was) : (fl.value != 0.0 ? 1.0 : 0.0);
+                const bool bad = (fl.check == Check::Exact        && std::abs(delta) > tol) ||
+                                 (fl.check == Check::HigherBetter && delta < -tol) ||
+                                 (fl.check == Check::LowerBetter  && delta > tol);
+                if (!bad) continue;
+                ++failures;
+                std::printf("  %-14s %-14s %12.6g -> %12.6g  (%+.1f%%)  REGRESSION\n",
+                            row.name.c_str(), fl.key, was, fl.value, delta * 100.0);
+            }
+        }
+        std::printf(failures ? "  %d failure(s)\n" : "  OK\n", failures);
+        return failures;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+    if (!opt.scenario.empty() &&
+        std::none_of(scenarios().begin(), scenarios().end(),
+                     [&](const Scenario& s) { return opt.scenario == s.name; })) {
+        std::cerr << "Unknown scenario " << opt.scenario << "\n";
+        return 2;
+    }
+
+    // Дочерний процесс: один сценарий, одна строка JSON для родителя
+    if (opt.child) {
+        for (const Scenario& s : scenarios()) {
+            if (opt.scenario != s.name) continue;
+            const Row row = playRepeated(s, opt.repeat);
+            std::printf("%s\n", rowJson(row, false).c_str());
+            return row.ok ? 0 : 3;
+        }
+    }
+
+    std::printf("%-14s %6s %7s %9s %13s %6s %7s %12s %10s\n", "scenario", "shots", "ticks", "b2 steps",
+                "contact-steps", "peak", "potted", "sim s/wall s",
+                opt.inProcess ? "proc KB" : "peak KB");
+    std::vector<Row> rows;
+    bool allOk = true;
+    for (const Scenario& s : scenarios()) {
+        if (!opt.scenario.empty() && opt.scenario != s.name) continue;
+
+        Row row = opt.inProcess ? playRepeated(s, opt.repeat) : playChild(argv[0], s, opt.repeat);
+        allOk &= row.ok;
+
+        const Metrics& m = row.m;
+        std::printf("%-14s %6ld %7ld %9llu %13llu %6d %7d %12.1f %10ld%s\n", s.name, m.shots, m.ticks,
+                    static_cast<unsigned long long>(m.b2Steps), static_cast<unsigned long long>(m.contactSteps),
+                    m.peakContacts, m.potted, m.simPerWall(kDt), m.peakRssKb, row.ok ? "" : "  FAIL");
+        std::fflush(stdout);
+        rows.push_back(std::move(row));
+    }
+    if (opt.inProcess)
+        std::cout << "proc KB: peak of the whole process so far (--in-process)\n";
+
+    for (const auto& [path, countersOnly] : { std::pair{ opt.json, false }, std::pair{ opt.writeBaseline, true } }) {
+        if (path.empty()) continue;
+        if (!allOk) {
+            std::cerr << "Not writing " << path << ": some scenarios failed\n";
+            return 1;
+        }
+        if (!writeJson(path, rows, countersOnly)) {
+            std::cerr << "Cannot write " << path << "\n";
+            return 1;
+        }
+        std::cout << (countersOnly ? "baseline: " : "json: ") << path << "\n";
+    }
+    if (!opt.baseline.empty() && compare(opt.baseline, rows, opt) > 0) return 1;
+    return allOk ? 0 : 1;
+}
@@ -0,0 +1,252 @@
+// billiards_sim — headless-прогон стола без окна и без ограничения 60 Гц.
+// Та же расстановка и тот же кадр физики, что и в main.cpp (sim::Simulation),
+// только удары генерируются случайно, а симуляция идёт с полной скоростью CPU.
+//
+// С --lookahead K перед каждым ударом K случайных вариантов просчитываются
+// параллельно (sim::ShotEvaluator), и бьётся тот, что забивает больше всего.
+//
+// --record-inputs пишет серию как .brpi (только удары и контрольные хеши);
+// --verify переигрывает такой файл и сообщает тик первого расхождения —
+// регрессионная сверка физики. С --record повтор пишется ещё и в .brpl.
+//
+//   billiards_sim [--shots N] [--seed S] [--max-impulse I] [--dt SEC]
+//                 [--backend box2d|analytic] [--lookahead K] [--threads T] [--quiet]
+//                 [--record FILE] [--record-inputs FILE] [--checkpoint-every N]
+//   billiards_sim --verify FILE [--record FILE]
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+
+#include "sim/Simulation.hpp"
+#include "sim/ShotEvaluator.hpp"
+#include "replay/InputLog.hpp"
+#include "replay/ReplayWriter.hpp"
+
+namespace {
+
+    struct Options {
+        int      shots      = 10;
+        unsigned seed       = 1;
+        float    maxDrag    = 2.0f;    // м, как у InputController в main.cpp
+        float    maxImpulse = 0.2f;    // Н·с
+        float    dt         = 1.0f / 120.0f;
+        int      lookahead  = 0;       // вариантов на удар (0 — бить первый случайный)
+        unsigned threads    = 0;       // 0 — по числу ядер
+        bool     quiet      = false;
+        std::string record;            // файл реплея (пусто — не писать)
+        std::string recordInputs;      // файл .brpi (пусто — не писать)
+        std::string verify;            // .brpi для сверки вместо серии ударов
+        unsigned checkpointTicks = replay::kCheckpointTicks;
+        physics::Backend backend = physics::Backend::Box2D;
+    };
+
+    bool parseArgs(int argc, char** argv, Options& opt)
+    {
+        for (int i = 1; i < argc; ++i) {
+            auto arg  = std::string(argv[i]);
+            auto next = [&]() -> const char* { return (i + 1 < argc) ? argv[++i] : nullptr; };
+
+            const char* v = nullptr;
+            if      (arg == "--quiet")                          opt.quiet      = true;
+            else if (arg == "--shots"       && (v = next()))    opt.shots      = std::atoi(v);
+            else if (arg == "--seed"        && (v = next()))    opt.seed       = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+            else if (arg == "--max-impulse" && (v = next()))    opt.maxImpulse = std::strtof(v, nullptr);
+            else if (arg == "--dt"          && (v = next()))    opt.dt         = std::strtof(v, nullptr);
+            else if (arg == "--lookahead"   && (v = next()))    opt.lookahead  = std::atoi(v);
+            else if (arg == "--threads"     && (v = next()))    opt.threads    = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+            else if (arg == "--record"      && (v = next()))    opt.record     = v;
+            else if (arg == "--record-inputs" && (v = next()))  opt.recordInputs = v;
+            else if (arg == "--verify"      && (v = next()))    opt.verify     = v;
+            else if (arg == "--checkpoint-every" && (v = next())) opt.checkpointTicks = static_cast<unsigned>(std::strtoul(v, nullptr, 10));
+            else if (arg == "--backend"     && (v = next()) && std::strcmp(v, "box2d") == 0)
+                opt.backend = physics::Backend::Box2D;
+            else if (arg == "--backend"     && v && std::strcmp(v, "analytic") == 0)
+                opt.backend = physics::Backend::Analytic;
+            else {
+                std::cerr << "Usage: billiards_sim [--shots N] [--seed S] [--max-impulse I] [--dt SEC]\n"
+                             "                     [--backend box2d|analytic] [--lookahead K] [--threads T] [--quiet]\n"
+                             "                     [--record FILE] [--record-inputs FILE] [--checkpoint-every N]\n"
+                             "       billiards_sim --verify FILE [--record FILE]\n";
+                return false;
+            }
+        }
+        return opt.shots >= 0 && opt.dt > 0.f && opt.lookahead >= 0 && opt.checkpointTicks > 0;
+    }
+
+    /// --verify: переиграть .brpi и сверить хеши. 0 — совпало, 3 — расхождение.
+    int verify(const Options& opt)
+    {
+        replay::InputLog log;
+        if (!log.load(opt.verify)) {
+            std::cerr << "Cannot read input replay " << opt.verify << "\n";
+            return 1;
+        }
+
+        sim::Simulation table(log.cfg, log.backend);
+        replay::ReplayWriter recorder;
+        std::function<void(std::uint64_t, const sim::Simulation&)> onTick;
+        if (!opt.record.empty()) {
+            if (!recorder.open(opt.record, log.step, physics::kBallLinearDamping)) {
+                std::cerr << "Cannot open replay file " << opt.record << "\n";
+                return 1;
+            }
+            recorder.record(0, table.world().balls(), table.score());
+            onTick = [&](std::uint64_t tick, const sim::Simulation& t) {
+                recorder.record(tick, t.world().balls(), t.score());
+            };
+        }
+
+        auto t0 = std::chrono::steady_clock::now();
+        const replay::InputVerdict v = replay::replayInputs(log, table, onTick);
+        double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+        std::cout << "shots:       " << log.shots.size() << "\n"
+                  << "ticks:       " << v.ticks << " / " << log.ticks << "\n"
+                  << "checkpoints: " << v.checked << " / " << log.checkpoints.size()
+                  << " (every " << log.checkpointTicks << " ticks)\n"
+                  << "score:       " << table.score() << "\n"
+                  << "wall time:   " << wall << " s\n";
+        if (v.ok) {
+            std::cout << "verify:      OK\n";
+        } else if (v.diverged == 0) {
+            std::cout << "verify:      DIVERGED at rack (initial state differs)\n";
+        } else {
+            std::cout << "verify:      DIVERGED at tick " << v.diverged
+                      << " (last match at tick " << v.lastGood << ")\n";
+        }
+        if (recorder.isOpen()) {
+            recorder.close();
+            std::cout << "replay:      " << opt.record << ", " << recorder.bytes() << " bytes\n";
+        }
+        return v.ok ? 0 : 3;
+    }
+
+} // namespace
+
+int main(int argc, char** argv)
+{
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 2;
+    if (!opt.verify.empty()) return verify(opt);
+
+    sim::Simulation table({}, opt.backend);
+    std::mt19937 rng(opt.seed);
+    std::uniform_real_distribution<float> angle(0.f, 6.2831853f);
+    std::uniform_real_distribution<float> drag(0.2f * opt.maxDrag, opt.maxDrag);
+
+    // Ограничение на длительность одного удара (в кадрах), чтобы не зависнуть
+    const long maxTicksPerShot = static_cast<long>(120.f / opt.dt);
+
+    // Перебор вариантов: пул потоков со своими столами, создаётся один раз
+    std::unique_ptr<sim::ShotEvaluator> evaluator;
+    if (opt.lookahead > 0)
+        evaluator = std::make_unique<sim::ShotEvaluator>(table.config(), opt.backend, opt.threads, opt.dt);
+    sim::Snapshot                 start;
+    std::vector<b2Vec2>           candidates;
+    std::vector<sim::ShotOutcome> outcomes;
+    double                        evalWall = 0.0;
+
+    // Реплей всей серии: состояние после каждого тика, тик 0 — расстановка
+    replay::ReplayWriter recorder;
+    if (!opt.record.empty()) {
+        if (!recorder.open(opt.record, opt.dt, physics::kBallLinearDamping)) {
+            std::cerr << "Cannot open replay file " << opt.record << "\n";
+            return 1;
+        }
+        recorder.record(0, table.world().balls(), table.score());
+    }
+    replay::InputRecorder inputs;
+    if (!opt.recordInputs.empty())
+        inputs.begin(table, opt.dt, opt.checkpointTicks);
+
+    long totalTicks = 0;
+    auto t0 = std::chrono::steady_clock::now();
+
+    for (int shot = 0; shot < opt.shots && table.ballsLeft() > 1; ++shot) {
+        // 1) Удар: случайная оттяжка → импульс по той же формуле, что у InputController
+        auto randomShot = [&] {
+            float a = angle(rng);
+            float d = drag(rng);
+            return sim::shotImpulse({ d * std::cos(a), d * std::sin(a) }, opt.maxDrag, opt.maxImpulse);
+        };
+
+        b2Vec2 impulse = randomShot();
+        if (evaluator) {
+            // Лучший из K вариантов: больше забитых, без потери битка
+            candidates.resize(opt.lookahead);
+            for (auto& c : candidates) c = randomShot();
+            table.snapshot(start);
+
+            auto e0 = std::chrono::steady_clock::now();
+            evaluator->evaluate(start, candidates, outcomes);
+            evalWall += std::chrono::duration<double>(std::chrono::steady_clock::now() - e0).count();
+
+            const int cue = table.cueSlot();
+            int best = std::numeric_limits<int>::min();
+            for (std::size_t i = 0; i < outcomes.size(); ++i) {
+                int gain = outcomes[i].cuePotted ? -1 : 0;
+                for (int slot : outcomes[i].potted) gain += (slot != cue);
+                if (gain > best) { best = gain; impulse = candidates[i]; }
+            }
+        }
+        if (!opt.recordInputs.empty())
+            inputs.shot(static_cast<std::uint64_t>(totalTicks), table.cueSlot(), impulse);
+        table.shoot(impulse);
+
+        // 2) Крутим кадры до полной остановки
+        long ticks  = 0;
+        int  potted = 0;
+        do {
+            potted += table.tick(opt.dt);
+            ++ticks;
+            recorder.record(static_cast<std::uint64_t>(totalTicks + ticks), table.world().balls(), table.score());
+            if (!opt.recordInputs.empty())
+                inputs.tick(static_cast<std::uint64_t>(totalTicks + ticks), table);
+        } while (!table.atRest() && ticks < maxTicksPerShot);
+        totalTicks += ticks;
+
+        if (!opt.quiet) {
+            std::cout << "shot " << shot
+                      << "  ticks=" << ticks
+                      << "  potted=" << potted
+                      << "  left=" << table.ballsLeft() - 1 << "\n";
+        }
+    }
+
+    double wall    = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double simTime = totalTicks * static_cast<double>(opt.dt);
+
+    std::cout << "ticks:      " << totalTicks << "\n"
+              << "score:      " << table.score() << "\n"
+              << "sim time:   " << simTime << " s\n"
+              << "wall time:  " << wall << " s\n"
+              << "speed:      " << (wall > 0.0 ? simTime / wall : 0.0) << "x realtime\n";
+    if (opt.backend == physics::Backend::Analytic)
+        std::cout << "events:     " << table.world().eventsProcessed() << "\n";
+    if (evaluator)
+        std::cout << "lookahead:  " << opt.lookahead << " x " << evaluator->threads() << " threads, "
+                  << evalWall << " s\n";
+    if (recorder.isOpen()) {
+        recorder.close();
+        std::cout << "replay:     " << opt.record << ", " << recorder.bytes() << " bytes"
+                  << (recorder.failed() ? " (truncated)" : "") << "\n";
+    }
+    if (!opt.recordInputs.empty()) {
+        const std::size_t bytes = inputs.log().save(opt.recordInputs);
+        if (bytes == 0) {
+            std::cerr << "Cannot write input replay " << opt.recordInputs << "\n";
+            return 1;
+        }
+        std::cout << "inputs:     " << opt.recordInputs << ", " << bytes << " bytes, "
+                  << inputs.log().checkpoints.size() << " checkpoints\n";
+    }
+    return 0;
+}
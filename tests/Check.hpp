@@ -0,0 +1,23 @@
+#ifndef CHECK_HPP
+#define CHECK_HPP
+
+#include <cstdio>
+
+// Проверки для ctest без внешнего фреймворка: CHECK печатает провал и считает его,
+// main() теста возвращает checkFailures() — ненулевой код выхода и есть провал.
+
+inline int& checkFailures()
+{
+    static int failures = 0;
+    return failures;
+}
+
+#define CHECK(cond)                                                                   \
+    do {                                                                              \
+        if (!(cond)) {                                                                \
+            std::fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            ++checkFailures();                                                        \
+        }                                                                             \
+    } while (0)
+
+#endif //CHECK_HPP
@@ -0,0 +1,101 @@
+// Реплей «только ввод» как регрессионная сверка физики: серия ударов, записанная
+// InputRecorder с контрольной точкой на каждом тике, переживает save/load и
+// переигрывается без расхождений; удар с изменённым битом импульса ловится ровно
+// на следующем за ним тике.
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <string>
+
+#include "Check.hpp"
+#include "replay/InputLog.hpp"
+
+namespace {
+
+    constexpr float kStep = 1.f / 60.f;
+
+    /// Фиксированная серия ударов — так же, как их применяет SimThread.
+    replay::InputLog recordSeries(physics::Backend backend)
+    {
+        sim::Simulation table({}, backend);
+        replay::InputRecorder rec;
+        rec.begin(table, kStep, 1);
+
+        std::uint64_t tick = 0;
+        auto run = [&](int n) {
+            for (int i = 0; i < n; ++i) { table.tick(kStep); rec.tick(++tick, table); }
+        };
+        auto shoot = [&](float dx, float dy, float speed) {
+            const int   cue  = table.cueSlot();
+            const float mass = table.world().body(cue)->GetMass();
+            const float len  = std::hypot(dx, dy);
+            const b2Vec2 impulse{ dx / len * speed * mass, dy / len * speed * mass };
+            table.world().applyImpulse(cue, impulse);
+            rec.shot(tick, cue, impulse);
+            for (int i = 0; i < 120 * 60 && !table.atRest(); ++i) run(1);
+        };
+
+        run(5);
+        const sim::TableConfig& cfg = table.config();
+        shoot(cfg.rackApexPx.x - cfg.cueStartPx.x, cfg.rackApexPx.y - cfg.cueStartPx.y, 8.f);
+        run(30);                      // простой между ударами
+        shoot(0.3f, -1.f, 3.f);
+        shoot(-1.f, 0.25f, 5.f);
+        run(10);
+        return rec.log();
+    }
+
+    void checkBackend(physics::Backend backend)
+    {
+        const replay::InputLog rec = recordSeries(backend);
+        CHECK(rec.shots.size() == 3);
+        CHECK(rec.checkpointTicks == 1);
+        CHECK(!rec.checkpoints.empty());
+
+        // save / load — побайтово тот же журнал
+        const std::string path = (std::filesystem::temp_directory_path() / "billiards_test_inputs.brpi").string();
+        CHECK(rec.save(path) > 0);
+        replay::InputLog log;
+        CHECK(log.load(path));
+        std::filesystem::remove(path);
+        CHECK(log.backend == backend && log.step == rec.step && log.rackHash == rec.rackHash);
+        CHECK(log.ticks == rec.ticks && log.finalHash == rec.finalHash);
+        CHECK(log.shots.size() == rec.shots.size() && log.checkpoints.size() == rec.checkpoints.size());
+
+        // Честный повтор
+        {
+            sim::Simulation table(log.cfg, log.backend);
+            const replay::InputVerdict v = replay::replayInputs(log, table);
+            CHECK(v.ok);
+            CHECK(v.ticks == log.ticks);
+            CHECK(v.checked == log.checkpoints.size());
+        }
+
+        // Второй удар с другим битом импульса: расхождение — на тике сразу после удара.
+        // Бит мантиссы повыше младшего: импульс меняется на ~0.1 %, а не на ulp
+        replay::InputLog bad = log;
+        replay::InputShot& shot = bad.shots[1];
+        shot.impulse.x = std::bit_cast<float>(std::bit_cast<std::uint32_t>(shot.impulse.x) ^ (1u << 13));
+        {
+            sim::Simulation table(bad.cfg, bad.backend);
+            const replay::InputVerdict v = replay::replayInputs(bad, table);
+            CHECK(!v.ok);
+            CHECK(v.diverged == shot.tick + 1);
+            CHECK(v.lastGood <= shot.tick);
+            if (v.diverged != shot.tick + 1)
+                std::fprintf(stderr, "  diverged at %llu, shot at %llu\n",
+                             static_cast<unsigned long long>(v.diverged),
+                             static_cast<unsigned long long>(shot.tick));
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    checkBackend(physics::Backend::Box2D);
+    checkBackend(physics::Backend::Analytic);
+    return checkFailures();
+}
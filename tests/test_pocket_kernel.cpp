@@ -0,0 +1,80 @@
+// physics::pottedMask (AVX2 / SSE2 / скалярный путь — что собралось) обязан
+// давать ровно те же биты, что поштучный inPocket, на любых длинах с хвостами
+// и с маской alive.
+
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+#include "Check.hpp"
+#include "physics/PocketKernel.hpp"
+#include "sim/Simulation.hpp"
+
+namespace {
+
+    /// Эталон: тот же контракт, что у pottedMask, циклом по inPocket.
+    std::vector<std::uint64_t> reference(const std::vector<float>& xs, const std::vector<float>& ys,
+                                         const std::uint8_t* alive, std::size_t n,
+                                         const std::vector<physics::Pocket>& pockets)
+    {
+        std::vector<std::uint64_t> out((n + 63) / 64, 0);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (alive && !alive[i]) continue;
+            for (const auto& p : pockets)
+                if (physics::inPocket(p, xs[i], ys[i])) { out[i >> 6] |= std::uint64_t{ 1 } << (i & 63); break; }
+        }
+        return out;
+    }
+
+} // namespace
+
+int main()
+{
+    const sim::TableConfig cfg;
+    const auto pockets = physics::defaultPockets(cfg.widthPx, cfg.heightPx, cfg.pocketRadiusPx);
+
+    // Половина точек — в окрестности карманов, чтобы попаданий и промахов было поровну
+    std::mt19937 rng(7);
+    std::uniform_real_distribution<float> ux(0.f, px2m(cfg.widthPx)), uy(0.f, px2m(cfg.heightPx));
+    std::uniform_real_distribution<float> near(-2.f * px2m(cfg.pocketRadiusPx), 2.f * px2m(cfg.pocketRadiusPx));
+    std::uniform_int_distribution<int> coin(0, 1);
+    std::uniform_int_distribution<std::size_t> pick(0, pockets.size() - 1);
+
+    for (std::size_t n : { 0u, 1u, 3u, 4u, 7u, 8u, 9u, 15u, 63u, 64u, 65u, 130u, 1000u }) {
+        std::vector<float> xs(n), ys(n);
+        std::vector<std::uint8_t> alive(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            if (coin(rng)) {
+                const physics::Pocket& p = pockets[pick(rng)];
+                xs[i] = p.center.x + near(rng);
+                ys[i] = p.center.y + near(rng);
+            } else {
+                xs[i] = ux(rng);
+                ys[i] = uy(rng);
+            }
+            alive[i] = static_cast<std::uint8_t>(coin(rng));
+        }
+
+        const std::uint8_t* masks[] = { nullptr, alive.data() };
+        for (const std::uint8_t* mask : masks) {
+            // Мусор в выходе: pottedMask обязан перезаписать все слова
+            std::vector<std::uint64_t> got((n + 63) / 64, ~std::uint64_t{ 0 });
+            physics::pottedMask(xs.data(), ys.data(), mask, n, pockets, got.data());
+            const auto want = reference(xs, ys, mask, n, pockets);
+            CHECK(got == want);
+            if (got != want)
+                std::fprintf(stderr, "  n = %zu, alive mask %s, isa %s\n", n, mask ? "on" : "off",
+                             physics::pocketKernelIsa());
+        }
+    }
+
+    // Перегрузка для BallStore: стартовая расстановка — ни одного шара в кармане
+    sim::Simulation table;
+    std::vector<std::uint64_t> mask;
+    physics::pottedMask(table.world().balls(), table.pockets(), mask);
+    CHECK(mask.size() == (table.world().balls().size() + 63) / 64);
+    for (std::uint64_t word : mask) CHECK(word == 0);
+
+    return checkFailures();
+}
@@ -0,0 +1,192 @@
+// Реплей .brpl: запись ReplayWriter → чтение ReplayReader. Позиции совпадают с
+// игрой в пределах допуска формата (tolerance + 1 единица), флаги alive и счёт —
+// точно, включая шар, снятый со стола и возвращённый обратно. seek() в любой тик
+// даёт ровно то же, что последовательное next(); обрезанный посреди записи файл
+// открывается, строит оглавление сам и читается до последнего целого тика.
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+#include "replay/ReplayReader.hpp"
+#include "replay/ReplayWriter.hpp"
+#include "sim/Simulation.hpp"
+
+namespace {
+
+    constexpr float kStep = 1.f / 60.f;
+
+    struct Truth {
+        physics::BallStore balls;
+        int                score = 0;
+    };
+
+    /// Фиксированная серия: разбой, пара ударов, шар снят со стола и возвращён rerack().
+    /// Пишет каждый тик в \p path, возвращает состояние игры на каждом тике.
+    std::vector<Truth> recordSeries(const std::string& path)
+    {
+        sim::Simulation table;
+        replay::ReplayWriter writer;
+        CHECK(writer.open(path, kStep, physics::kBallLinearDamping));
+
+        std::vector<Truth> truth;
+        auto record = [&] {
+            const std::uint64_t tick = truth.size();
+            writer.record(tick, table.world().balls(), table.score());
+            truth.push_back({ table.world().balls(), table.score() });
+        };
+        auto runToRest = [&] {
+            for (int i = 0; i < 120 * 60; ++i) {
+                table.tick(kStep);
+                record();
+                if (table.atRest()) break;
+            }
+        };
+        auto shoot = [&](float dx, float dy, float speed) {
+            const float mass = table.world().body(table.cueSlot())->GetMass();
+            const float len  = std::hypot(dx, dy);
+            table.shoot({ dx / len * speed * mass, dy / len * speed * mass });
+            runToRest();
+        };
+
+        record();                                              // тик 0 — расстановка
+        const sim::TableConfig& cfg = table.config();
+        shoot(cfg.rackApexPx.x - cfg.cueStartPx.x, cfg.rackApexPx.y - cfg.cueStartPx.y, 8.f);
+        shoot(0.3f, -1.f, 3.f);
+        for (int i = 0; i < 30; ++i) { table.tick(kStep); record(); }   // стоящий стол — kIdle
+
+        // Снять шар (alive 1 → 0), постоять, вернуть расстановку (0 → 1) и ещё удар
+        int victim = -1;
+        const physics::BallStore& b = table.world().balls();
+        for (int i = 0; i < static_cast<int>(b.size()) && victim < 0; ++i)
+            if (b.alive[i] && i != table.cueSlot()) victim = i;
+        CHECK(victim >= 0);
+        table.world().pot(victim);
+        for (int i = 0; i < 10; ++i) { table.tick(kStep); record(); }
+        table.rerack();
+        record();
+        shoot(1.f, 0.2f, 5.f);
+
+        // Добить запись до нескольких ключевых кадров: удары веером, пока хватит тиков
+        for (int i = 0; i < 40 && truth.size() < 3 * replay::kKeyframeTicks; ++i)
+            shoot(std::cos(0.7f * static_cast<float>(i)), std::sin(0.7f * static_cast<float>(i)), 4.f);
+
+        writer.close();
+        CHECK(!writer.failed());
+        return truth;
+    }
+
+    /// Прочитанный тик: сравнивается побитно — декодер целочисленный.
+    struct Decoded {
+        std::vector<float>        x, y, vx, vy;
+        std::vector<std::uint8_t> alive;
+        int                       score = 0;
+
+        explicit Decoded(const replay::ReplayReader& r)
+            : x(r.balls().x), y(r.balls().y), vx(r.balls().vx), vy(r.balls().vy)
+            , alive(r.balls().alive), score(r.score()) {}
+
+        bool operator==(const Decoded&) const = default;
+    };
+
+    /// Случайные seek() против последовательного чтения \p decoded (тик = индекс).
+    void checkSeeks(replay::ReplayReader& reader, const std::vector<Decoded>& decoded, unsigned seed)
+    {
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<std::uint64_t> pick(0, decoded.size() - 1);
+        std::vector<std::uint64_t> ticks = { 0, decoded.size() - 1, replay::kKeyframeTicks,
+                                             replay::kKeyframeTicks - 1, replay::kKeyframeTicks + 1 };
+        for (int i = 0; i < 200; ++i) ticks.push_back(pick(rng));
+
+        for (std::uint64_t t : ticks) {
+            if (t >= decoded.size()) continue;
+            CHECK(reader.seek(t));
+            CHECK(reader.tick() == t);
+            CHECK(Decoded(reader) == decoded[t]);
+        }
+        // Назад после перемотки вперёд и next() сразу после seek()
+        const std::uint64_t mid = decoded.size() / 2;
+        CHECK(reader.seek(mid));
+        if (reader.next()) CHECK(Decoded(reader) == decoded[mid + 1]);
+        CHECK(reader.seek(1) && Decoded(reader) == decoded[1]);
+    }
+
+} // namespace
+
+int main()
+{
+    const std::filesystem::path dir  = std::filesystem::temp_directory_path();
+    const std::string           path = (dir / "billiards_test_replay.brpl").string();
+
+    const std::vector<Truth> truth = recordSeries(path);
+    CHECK(truth.size() > 2 * replay::kKeyframeTicks);   // хотя бы пара ключевых кадров
+
+    replay::ReplayReader reader;
+    CHECK(reader.open(path));
+    CHECK(!reader.truncated());
+    CHECK(reader.ticks() == truth.size());
+    CHECK(reader.keyframes() >= 1);
+
+    // Последовательное чтение против игры
+    const float tol   = (replay::kTolerance + 1) / replay::kUnitsPerMeter + 1e-6f;
+    float       worst = 0.f;
+    bool        sawDead = false;
+    std::vector<Decoded> decoded;
+    std::uint64_t t = 0;
+    do {
+        decoded.emplace_back(reader);
+        CHECK(reader.tick() == t);
+        const physics::BallStore& got  = reader.balls();
+        const physics::BallStore& want = truth[t].balls;
+        CHECK(got.size() == want.size());
+        CHECK(reader.score() == truth[t].score);
+        for (std::size_t i = 0; i < want.size() && i < got.size(); ++i) {
+            CHECK(got.alive[i] == want.alive[i]);
+            sawDead |= !want.alive[i];
+            if (!want.alive[i]) continue;
+            worst = std::max({ worst, std::abs(got.x[i] - want.x[i]), std::abs(got.y[i] - want.y[i]) });
+        }
+        ++t;
+    } while (reader.next());
+    CHECK(t == truth.size());
+    CHECK(sawDead);
+    CHECK(worst <= tol);
+    if (worst > tol) std::fprintf(stderr, "  worst position error %.6f m > %.6f m\n", worst, tol);
+
+    checkSeeks(reader, decoded, 3);
+    reader.close();
+
+    // Файл, оборванный посреди записей: без kEnd и оглавления в хвосте
+    const std::string cutPath = (dir / "billiards_test_replay_cut.brpl").string();
+    {
+        std::ifstream in(path, std::ios::binary);
+        std::vector<char> bytes((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+        std::ofstream out(cutPath, std::ios::binary);
+        out.write(bytes.data(), static_cast<std::streamsize>(bytes.size() * 3 / 5));
+    }
+    replay::ReplayReader cut;
+    CHECK(cut.open(cutPath));
+    CHECK(cut.truncated());
+    CHECK(cut.keyframes() >= 1);
+    CHECK(cut.ticks() > 0 && cut.ticks() < truth.size());
+
+    std::vector<Decoded> prefix;
+    do {
+        CHECK(cut.tick() == prefix.size());
+        if (prefix.size() < decoded.size()) CHECK(Decoded(cut) == decoded[prefix.size()]);
+        prefix.emplace_back(cut);
+    } while (cut.next());
+    CHECK(prefix.size() == cut.ticks());
+    if (!prefix.empty()) checkSeeks(cut, prefix, 5);
+
+    cut.close();
+    std::filesystem::remove(cutPath);
+    std::filesystem::remove(path);
+    return checkFailures();
+}
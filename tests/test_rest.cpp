@@ -0,0 +1,47 @@
+// Покатившийся шар обязан остановиться: World::settle гасит остаточные скорости,
+// усыпляет тело, и стол уходит в покой (atRest, затем idle) — на обоих бэкендах.
+
+#include "Check.hpp"
+#include "sim/Simulation.hpp"
+
+namespace {
+
+    void rollToRest(physics::Backend backend)
+    {
+        sim::Simulation table({}, backend);
+        const int cue = table.cueSlot();
+        CHECK(cue >= 0);
+
+        // 1 м/с вдоль короткой оси — ни в кого не попадает, до борта не доходит
+        const float mass = table.world().body(cue)->GetMass();
+        CHECK(table.shoot({ 0.f, -1.f * mass }));
+        CHECK(!table.atRest());
+
+        constexpr float dt       = 1.f / 60.f;
+        constexpr long  maxTicks = 30 * 60;   // без гашения шар ползёт бесконечно
+        long ticks = 0;
+        while (!table.atRest() && ticks < maxTicks) { table.tick(dt); ++ticks; }
+        CHECK(table.atRest());
+
+        // В покое settle() обязан дожать и угловую скорость, и сон тела
+        for (int i = 0; i < 4 && !table.world().idle(); ++i) table.tick(dt);
+        CHECK(table.world().idle());
+        CHECK(table.world().awakeCount() == 0);
+
+        const physics::BallStore& b = table.world().balls();
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            if (!b.alive[i]) continue;
+            CHECK(b.vx[i] == 0.f && b.vy[i] == 0.f);
+            CHECK(b.w[i] == 0.f);
+            CHECK(b.awake[i] == 0);
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    rollToRest(physics::Backend::Box2D);
+    rollToRest(physics::Backend::Analytic);
+    return checkFailures();
+}
@@ -0,0 +1,62 @@
+// ShotEvaluator: одни и те же импульсы дают бит в бит одинаковые ShotOutcome
+// при 1 и при N потоках и в любом порядке раздачи — итог кандидата не зависит
+// от того, что этот поток считал до него.
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+#include "Check.hpp"
+#include "sim/ShotEvaluator.hpp"
+
+namespace {
+
+    bool sameOutcome(const sim::ShotOutcome& a, const sim::ShotOutcome& b)
+    {
+        if (a.potted != b.potted || a.cuePotted != b.cuePotted || a.ticks != b.ticks) return false;
+        if (a.final.balls.size() != b.final.balls.size()) return false;
+        // Побайтно: ±0 и NaN тоже должны совпасть
+        return std::memcmp(a.final.balls.data(), b.final.balls.data(),
+                           a.final.balls.size() * sizeof(physics::BallSnapshot)) == 0;
+    }
+
+    void compareThreads(physics::Backend backend)
+    {
+        sim::Simulation table({}, backend);
+        sim::Snapshot start;
+        table.snapshot(start);
+
+        // Веер ударов от слабых до разбоя: часть в пирамиду, часть в борта
+        const float mass = table.world().body(table.cueSlot())->GetMass();
+        std::vector<b2Vec2> impulses;
+        for (int i = 0; i < 24; ++i) {
+            const float angle = -0.6f + 1.2f * static_cast<float>(i) / 23.f + (i % 2 ? 3.1415927f : 0.f);
+            const float speed = 1.f + 7.f * static_cast<float>(i % 6) / 5.f;   // 1..8 м/с
+            impulses.push_back({ std::cos(angle) * speed * mass, std::sin(angle) * speed * mass });
+        }
+        std::vector<b2Vec2> reversed(impulses.rbegin(), impulses.rend());
+
+        sim::ShotEvaluator one({}, backend, 1);
+        sim::ShotEvaluator many({}, backend, 4);
+        const auto serial   = one.evaluate(start, impulses);
+        const auto parallel = many.evaluate(start, impulses);
+        const auto backward = one.evaluate(start, reversed);   // тот же поток, другая история
+        const auto again    = many.evaluate(start, impulses);  // повтор на уже поработавших потоках
+
+        CHECK(serial.size() == impulses.size());
+        for (std::size_t i = 0; i < impulses.size(); ++i) {
+            CHECK(serial[i].ticks > 0);
+            CHECK(sameOutcome(serial[i], parallel[i]));
+            CHECK(sameOutcome(serial[i], backward[impulses.size() - 1 - i]));
+            CHECK(sameOutcome(serial[i], again[i]));
+        }
+    }
+
+} // namespace
+
+int main()
+{
+    compareThreads(physics::Backend::Box2D);
+    compareThreads(physics::Backend::Analytic);
+    return checkFailures();
+}
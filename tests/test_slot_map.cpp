@@ -0,0 +1,50 @@
+// SlotMap: удаление из середины переносит последний элемент (swap-remove),
+// handle удалённого перестаёт разрешаться — и после повторного занятия слота,
+// а handle перенесённого элемента продолжает указывать на него.
+
+#include <string>
+#include <vector>
+
+#include "Check.hpp"
+#include "physics/SlotMap.hpp"
+
+int main()
+{
+    physics::SlotMap<std::string> map;
+    const physics::SlotHandle a = map.emplace("a");
+    const physics::SlotHandle b = map.emplace("b");
+    const physics::SlotHandle c = map.emplace("c");
+    CHECK(map.size() == 3);
+    CHECK(map.get(b) && *map.get(b) == "b");
+    CHECK(physics::SlotHandle{}.isNull() && !map.contains(physics::SlotHandle{}));
+
+    // Средний элемент: на его место в плотном массиве переезжает "c"
+    CHECK(map.erase(b));
+    CHECK(map.size() == 2);
+    CHECK(!map.contains(b));
+    CHECK(map.get(b) == nullptr);
+    CHECK(!map.erase(b));                         // повторное удаление — не ошибка, а false
+    CHECK(map.get(a) && *map.get(a) == "a");
+    CHECK(map.get(c) && *map.get(c) == "c");      // перенесённый элемент по старому handle
+    CHECK(map.handleAt(1) == c);                  // и на новом месте плотного массива
+
+    std::vector<std::string> dense(map.begin(), map.end());
+    CHECK((dense == std::vector<std::string>{ "a", "c" }));
+
+    // Слот "b" занимается заново: индекс тот же, поколение другое
+    const physics::SlotHandle d = map.emplace("d");
+    CHECK(d.index == b.index && d.generation != b.generation);
+    CHECK(map.get(b) == nullptr);
+    CHECK(map.get(d) && *map.get(d) == "d");
+
+    // Удаление последнего — без переноса
+    CHECK(map.erase(d));
+    CHECK(map.get(a) && *map.get(a) == "a");
+    CHECK(map.get(c) && *map.get(c) == "c");
+
+    map.clear();
+    CHECK(map.empty());
+    CHECK(map.get(a) == nullptr && map.get(c) == nullptr);
+
+    return checkFailures();
+}